@@ -23,6 +23,9 @@ function(build_pelec_exe pelec_exe_name)
                  ${PELEC_EOS_DIR}/EOS.cpp
                  ${PELEC_EOS_DIR}/EOS.H)
   target_include_directories(${pelec_exe_name} SYSTEM PRIVATE ${PELEC_EOS_DIR})
+  if(PELEC_EOS_MODEL STREQUAL "Fuego" OR PELEC_EOS_MODEL STREQUAL "GammaLaw")
+    target_compile_definitions(${pelec_exe_name} PRIVATE PELEC_EOS_IDEAL_GAS)
+  endif()
 
   set(PELEC_MECHANISM_DIR "${PELE_PHYSICS_SRC_DIR}/Support/Fuego/Mechanism/Models/${PELEC_CHEMISTRY_MODEL}")
   target_sources(${pelec_exe_name} PRIVATE
@@ -93,11 +96,23 @@ function(build_pelec_exe pelec_exe_name)
        ${SRC_DIR}/Particle.cpp
        ${SRC_DIR}/PeleC.H
        ${SRC_DIR}/PeleC.cpp
+       ${SRC_DIR}/PltCompress.H
+       ${SRC_DIR}/PltCompress.cpp
        ${SRC_DIR}/Problem.H
        ${SRC_DIR}/ProblemDerive.H
        ${SRC_DIR}/Riemann.H
+       ${SRC_DIR}/Sampling.H
+       ${SRC_DIR}/Sampling.cpp
+       ${SRC_DIR}/ScratchArena.H
+       ${SRC_DIR}/ScratchArena.cpp
+       ${SRC_DIR}/PrimCache.H
+       ${SRC_DIR}/PrimCache.cpp
+       ${SRC_DIR}/NSCBC.H
+       ${SRC_DIR}/NSCBC.cpp
        ${SRC_DIR}/Setup.cpp
        ${SRC_DIR}/Sources.cpp
+       ${SRC_DIR}/StlGeometry.H
+       ${SRC_DIR}/StlGeometry.cpp
        ${SRC_DIR}/SumIQ.cpp
        ${SRC_DIR}/SumUtils.cpp
        ${SRC_DIR}/Tagging.H
@@ -106,6 +121,7 @@ function(build_pelec_exe pelec_exe_name)
        ${SRC_DIR}/Timestep.cpp
        ${SRC_DIR}/Utilities.H
        ${SRC_DIR}/Utilities.cpp
+       ${SRC_DIR}/WENO.H
   )
 
   if(NOT "${pelec_exe_name}" STREQUAL "pelec_unit_tests")
@@ -0,0 +1,70 @@
+# ========================================================================
+#
+# Imports
+#
+# ========================================================================
+import os
+import re
+import numpy as np
+import numpy.testing as npt
+import unittest
+
+
+# ========================================================================
+#
+# Helpers
+#
+# ========================================================================
+def read_log(fname):
+    """Log, number of steps and total masses of a run."""
+    with open(fname, "r") as f:
+        log = f.read()
+    nsteps = len(re.findall(r"STEP = \d+ ends\.", log))
+    masses = [float(m) for m in re.findall(r"TIME= \S+ MASS\s+= (\S+)", log)]
+    return log, nsteps, np.array(masses)
+
+
+# ========================================================================
+#
+# Test definitions
+#
+# ========================================================================
+class EBCacheTestCase(unittest.TestCase):
+    """EB structures read from ebd.cache_dir with regrids on several ranks."""
+
+    def test_cache_dir(self):
+        """Does the run reading the EB structures match the first one?"""
+
+        fdir = os.path.abspath(".")
+        log_a, nsteps_a, mass_a = read_log(
+            os.path.join(fdir, "eb-bluffbody-cache-a.log")
+        )
+        log_b, nsteps_b, mass_b = read_log(
+            os.path.join(fdir, "eb-bluffbody-cache-b.log")
+        )
+
+        # Both runs went through all their steps and regrids
+        self.assertEqual(nsteps_a, 10)
+        self.assertEqual(nsteps_b, 10)
+
+        # The first run wrote the structures of both levels unless an
+        # earlier run of the test did, the second one read them
+        for lev in range(2):
+            written = "Level {0:d} EB2 structs written to".format(lev)
+            read = "Level {0:d} EB2 structs read from".format(lev)
+            self.assertTrue(written in log_a or read in log_a)
+            self.assertTrue(read in log_b)
+            self.assertFalse(written in log_b)
+
+        # The structures read are those that were built
+        self.assertTrue(np.all(np.isfinite(mass_a)))
+        npt.assert_allclose(mass_b, mass_a, rtol=1e-12)
+
+
+# ========================================================================
+#
+# Main
+#
+# ========================================================================
+if __name__ == "__main__":
+    unittest.main()
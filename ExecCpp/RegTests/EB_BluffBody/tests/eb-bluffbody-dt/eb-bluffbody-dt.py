@@ -0,0 +1,126 @@
+# ========================================================================
+#
+# Imports
+#
+# ========================================================================
+import os
+import re
+import numpy as np
+import numpy.testing as npt
+import unittest
+
+
+# ========================================================================
+#
+# Helpers
+#
+# ========================================================================
+def read_log(fname):
+    """Time steps and total masses reported in a log."""
+    with open(fname, "r") as f:
+        log = f.read()
+    dts = [
+        float(dt)
+        for dt in re.findall(r"STEP = \d+ ends\. TIME = \S+ DT = (\S+)", log)
+    ]
+    masses = [float(m) for m in re.findall(r"TIME= \S+ MASS\s+= (\S+)", log)]
+    return np.array(dts), np.array(masses)
+
+
+def read_plotfile(pdir):
+    """Variables of the cells of a single level plotfile."""
+    with open(os.path.join(pdir, "Header"), "r") as f:
+        f.readline()
+        nvars = int(f.readline())
+        names = [f.readline().strip() for n in range(nvars)]
+    with open(os.path.join(pdir, "Level_0", "Cell_H"), "r") as f:
+        fabs = re.findall(r"FabOnDisk: (\S+) (\d+)", f.read())
+
+    data = {name: [] for name in names}
+    for fname, offset in fabs:
+        with open(os.path.join(pdir, "Level_0", fname), "rb") as f:
+            f.seek(int(offset))
+            header = f.readline().decode()
+            # Byte order of the doubles, (8 7 6 5 4 3 2 1) on x86
+            order = ">" if "(8, (1 2 3 4 5 6 7 8))" in header else "<"
+            box = re.search(r"\(\(([-\d,]+)\) \(([-\d,]+)\)", header)
+            lo = np.array([int(x) for x in box.group(1).split(",")])
+            hi = np.array([int(x) for x in box.group(2).split(",")])
+            ncells = np.prod(hi - lo + 1)
+            ncomp = int(header.split()[-1])
+            values = np.fromfile(f, dtype=order + "f8", count=ncells * ncomp)
+        for n, name in enumerate(names[:ncomp]):
+            data[name].append(values[n * ncells : (n + 1) * ncells])
+    return {name: np.concatenate(data[name]) for name in names}
+
+
+def density_range(pdir):
+    """Smallest and largest density of the cells that are not covered."""
+    data = read_plotfile(pdir)
+    rho = data["density"][data["vfrac"] > 0.0]
+    return np.min(rho), np.max(rho)
+
+
+def mass(pdir):
+    """Mass in the domain, in units of the cell volume."""
+    data = read_plotfile(pdir)
+    return np.sum(data["density"] * data["vfrac"])
+
+
+# ========================================================================
+#
+# Test definitions
+#
+# ========================================================================
+class RedistributionTestCase(unittest.TestCase):
+    """Time steps of the flux and state redistributions in Pele."""
+
+    def test_time_step(self):
+        """Does the state redistribution run at a larger time step?"""
+
+        fdir = os.path.abspath(".")
+        dt_flux, mass_flux = read_log(
+            os.path.join(fdir, "eb-bluffbody-dt-a.log")
+        )
+        dt_state, mass_state = read_log(
+            os.path.join(fdir, "eb-bluffbody-dt-b.log")
+        )
+
+        # Both runs went through all their steps with a physical state
+        self.assertEqual(len(dt_flux), 20)
+        self.assertEqual(len(dt_state), 20)
+        for m in (mass_flux, mass_state):
+            self.assertTrue(np.all(np.isfinite(m)))
+            self.assertTrue(np.all(m > 0.0))
+
+        # The state redistribution is run at 3 times the CFL of the flux
+        # redistribution, the time steps follow it
+        npt.assert_array_less(2.5 * dt_flux, dt_state)
+
+    def test_state_redistribution(self):
+        """Is the state redistribution bounded and conservative?"""
+
+        fdir = os.path.abspath(".")
+
+        # Uniform flow impinging on the body, the density of the acoustic
+        # waves it sends back stays within these bounds
+        rho0 = 0.00116
+        rho_min, rho_max = density_range(os.path.join(fdir, "plt_state00020"))
+        self.assertGreater(rho_min, 0.5 * rho0)
+        self.assertLess(rho_max, 1.5 * rho0)
+
+        # The mass in the periodic domain is conserved
+        npt.assert_allclose(
+            mass(os.path.join(fdir, "plt_state00020")),
+            mass(os.path.join(fdir, "plt_state00000")),
+            rtol=1e-12,
+        )
+
+
+# ========================================================================
+#
+# Main
+#
+# ========================================================================
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,93 @@
+# ========================================================================
+#
+# Imports
+#
+# ========================================================================
+import os
+import re
+import numpy as np
+import numpy.testing as npt
+import unittest
+
+
+# ========================================================================
+#
+# Helpers
+#
+# ========================================================================
+def read_log(fname):
+    """Log, time steps and total masses of a run."""
+    with open(fname, "r") as f:
+        log = f.read()
+    dts = [
+        float(dt)
+        for dt in re.findall(r"STEP = \d+ ends\. TIME = \S+ DT = (\S+)", log)
+    ]
+    masses = [float(m) for m in re.findall(r"TIME= \S+ MASS\s+= (\S+)", log)]
+    return log, np.array(dts), np.array(masses)
+
+
+def reused_grids(log):
+    """Reused and cut grids of each EB structure build, in order."""
+    return [
+        (int(lev), int(nreused), int(ncut))
+        for lev, nreused, ncut in re.findall(
+            r"Level (\d+) EB2 structs initialized in \S+ s, "
+            r"(\d+) of (\d+) cut grids reused",
+            log,
+        )
+    ]
+
+
+# ========================================================================
+#
+# Test definitions
+#
+# ========================================================================
+class EBRestartTestCase(unittest.TestCase):
+    """EB structures saved with the checkpoints with ebd.checkpoint_cache."""
+
+    def test_restart(self):
+        """Does the restart read the EB structures and match the first run?"""
+
+        fdir = os.path.abspath(".")
+        log_a, dt_a, mass_a = read_log(
+            os.path.join(fdir, "eb-bluffbody-restart-a.log")
+        )
+        log_b, dt_b, mass_b = read_log(
+            os.path.join(fdir, "eb-bluffbody-restart-b.log")
+        )
+
+        # The first run went through all its steps, the restart through the
+        # last five
+        self.assertEqual(len(dt_a), 10)
+        self.assertEqual(len(dt_b), 5)
+
+        # The first run saved the structures of both levels in its
+        # checkpoints, the restart read them and built nothing
+        for lev in range(2):
+            written = "Level {0:d} EB2 structs written to chk00005/EB".format(
+                lev
+            )
+            read = "Level {0:d} EB2 structs read from chk00005/EB".format(lev)
+            self.assertTrue(written in log_a)
+            self.assertTrue(read in log_b)
+        restart_builds = reused_grids(log_b)[:2]
+        self.assertEqual([b[0] for b in restart_builds], [0, 1])
+        for lev, nreused, ncut in restart_builds:
+            self.assertGreater(ncut, 0)
+            self.assertEqual(nreused, ncut)
+
+        # The restart continues the first run
+        self.assertTrue(np.all(np.isfinite(mass_a)))
+        npt.assert_allclose(dt_b, dt_a[5:], rtol=1e-12)
+        npt.assert_allclose(mass_b[-5:], mass_a[-5:], rtol=1e-12)
+
+
+# ========================================================================
+#
+# Main
+#
+# ========================================================================
+if __name__ == "__main__":
+    unittest.main()
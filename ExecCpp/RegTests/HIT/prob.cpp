@@ -1,9 +1,12 @@
+#include <memory>
+
 #include "prob.H"
 
 namespace ProbParm {
 std::string iname = "";
 AMREX_GPU_DEVICE_MANAGED bool binfmt = false;
 AMREX_GPU_DEVICE_MANAGED bool restart = false;
+bool node_bcast = false;
 AMREX_GPU_DEVICE_MANAGED amrex::Real lambda0 = 0.5;
 AMREX_GPU_DEVICE_MANAGED amrex::Real reynolds_lambda0 = 100.0;
 AMREX_GPU_DEVICE_MANAGED amrex::Real mach_t0 = 0.1;
@@ -76,6 +79,7 @@ amrex_probinit(
   pp.query("iname", ProbParm::iname);
   pp.query("binfmt", ProbParm::binfmt);
   pp.query("restart", ProbParm::restart);
+  pp.query("node_bcast", ProbParm::node_bcast);
   pp.query("lambda0", ProbParm::lambda0);
   pp.query("reynolds_lambda0", ProbParm::reynolds_lambda0);
   pp.query("mach_t0", ProbParm::mach_t0);
@@ -148,11 +152,22 @@ amrex_probinit(
     const size_t nx = ProbParm::inres;
     const size_t ny = ProbParm::inres;
     const size_t nz = ProbParm::inres;
-    amrex::Vector<double> data(nx * ny * nz * 6); /* this needs to be double */
-    if (ProbParm::binfmt) {
-      read_binary(ProbParm::iname, nx, ny, nz, 6, data);
+    // Binary files are read in place unless they are broadcast on the nodes
+    amrex::Vector<double> vdata; /* this needs to be double */
+    std::unique_ptr<BinaryView> view;
+    const double* data = nullptr;
+    if (ProbParm::binfmt && !ProbParm::node_bcast) {
+      view.reset(new BinaryView(ProbParm::iname, nx, ny, nz, 6));
+      data = view->data();
     } else {
-      read_csv(ProbParm::iname, nx, ny, nz, data);
+      vdata.resize(nx * ny * nz * 6);
+      if (ProbParm::binfmt) {
+        read_binary(
+          ProbParm::iname, nx, ny, nz, 6, vdata, ProbParm::node_bcast);
+      } else {
+        read_csv(ProbParm::iname, nx, ny, nz, vdata, ProbParm::node_bcast);
+      }
+      data = vdata.data();
     }
 
     // Extract position and velocities
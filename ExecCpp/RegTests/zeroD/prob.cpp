@@ -8,6 +8,8 @@ AMREX_GPU_DEVICE_MANAGED amrex::Real Y_init_N2 = 0.44;
 AMREX_GPU_DEVICE_MANAGED amrex::Real T_init = 940.0;
 AMREX_GPU_DEVICE_MANAGED amrex::Real rho_init = 0.0;
 AMREX_GPU_DEVICE_MANAGED amrex::Real e_init = 0.0;
+AMREX_GPU_DEVICE_MANAGED amrex::Real kernel_radius = 0.0;
+AMREX_GPU_DEVICE_MANAGED amrex::Real kernel_T = 1500.0;
 AMREX_GPU_DEVICE_MANAGED amrex::GpuArray<amrex::Real, NUM_SPECIES> massfrac = {
   0.0};
 } // namespace ProbParm
@@ -34,6 +36,8 @@ amrex_probinit(
   pp.query("Y_init_O2", ProbParm::Y_init_O2);
   pp.query("Y_init_N2", ProbParm::Y_init_N2);
   pp.query("T_init", ProbParm::T_init);
+  pp.query("kernel_radius", ProbParm::kernel_radius);
+  pp.query("kernel_T", ProbParm::kernel_T);
 
   // Initial values
   ProbParm::massfrac[H2_ID] = ProbParm::Y_init_H2;
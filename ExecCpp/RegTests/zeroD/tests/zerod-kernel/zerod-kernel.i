@@ -0,0 +1,67 @@
+# ------------------  INPUTS TO MAIN PROGRAM  -------------------
+# Ignition kernel benchmark for the chemistry redistribution. The hot
+# kernel sits on a few ranks only. Compare the chemistry parallel
+# efficiency printed each step with pelec.chem_redistribute = 0 and 1.
+stop_time = 0.001
+max_step = 10
+
+# PROBLEM SIZE & GEOMETRY
+geometry.is_periodic = 1 1 1
+geometry.coord_sys   = 0  # 0 => cart, 1 => RZ  2=>spherical
+geometry.prob_lo     =   0.0  0.0  0.0
+geometry.prob_hi     =   1.0  1.0  1.0
+amr.n_cell           =   32   32   32
+
+# >>>>>>>>>>>>>  BC KEYWORDS <<<<<<<<<<<<<<<<<<<<<<
+# Interior, UserBC, Symmetry, SlipWall, NoSlipWall
+# >>>>>>>>>>>>>  BC KEYWORDS <<<<<<<<<<<<<<<<<<<<<<
+pelec.lo_bc       =  "Interior" "Interior" "Interior"
+pelec.hi_bc       =  "Interior" "Interior" "Interior"
+
+# WHICH PHYSICS
+pelec.do_react = 1
+pelec.do_hydro = 1
+pelec.diffuse_temp = 0
+pelec.diffuse_enth = 0
+pelec.diffuse_spec = 0
+pelec.diffuse_vel = 0
+pelec.sdc_iters = 1
+pelec.flame_trac_name = HO2
+pelec.chem_redistribute = 1
+pelec.chem_redistribute_T = 1200.0
+
+# TIME STEP CONTROL
+pelec.fixed_dt       = 1.0e-6
+pelec.dt_cutoff      = 5.e-20  # level 0 timestep below which we halt
+
+# DIAGNOSTICS & VERBOSITY
+pelec.sum_interval = 1       # coarse time steps between computing mass on domain
+pelec.v            = 2       # verbosity in PeleC cpp files
+amr.v              = 1       # verbosity in Amr.cpp
+
+# REFINEMENT / REGRIDDING
+amr.max_level       = 0       # maximum level number allowed
+amr.blocking_factor = 8       # block factor in grid generation
+amr.max_grid_size   = 8
+
+# CHECKPOINT FILES
+amr.checkpoint_files_output = 0
+
+# PLOTFILES
+amr.plot_files_output = 1
+amr.plot_file         = plt     # root name of plotfile
+amr.plot_int          = 10      # number of timesteps between plotfiles
+amr.derive_plot_vars = density Temp pressure
+pelec.plot_rhoy = 0
+pelec.plot_massfrac = 1
+
+# PROBLEM PARAMETERS
+prob.p_init    = 1013250.0
+prob.Y_init_H2 = 0.06
+prob.Y_init_O2 = 0.5
+prob.Y_init_N2 = 0.44
+prob.T_init    = 700.0
+prob.kernel_radius = 0.15
+prob.kernel_T  = 1500.0
+
+amrex.signal_handling=0
@@ -0,0 +1,123 @@
+/** \file test-compact.cpp
+ *
+ *  Checks the stream compaction, sort and unique used to build the EB cut
+ *  cell and cut face lists against their serial counterparts, and reports
+ *  the time of the cut cell list build of a tile next to the original
+ *  BoxIterator pass followed by a bubble sort
+ */
+
+#include "gtest/gtest.h"
+#include "AMReX_Print.H"
+#include "AMReX_Utility.H"
+#include "AMReX_BoxIterator.H"
+
+#include "Utilities.H"
+
+namespace pelec_tests {
+
+#ifndef AMREX_USE_GPU
+namespace {
+
+// Cells within half a cell of a sphere, standing in for the cut cells
+bool
+is_cut(const amrex::IntVect& iv, const amrex::Real r)
+{
+  amrex::Real d2 = 0.0;
+  for (int d = 0; d < AMREX_SPACEDIM; d++) {
+    d2 += (iv[d] + 0.5) * (iv[d] + 0.5);
+  }
+  return std::abs(std::sqrt(d2) - r) < 0.5;
+}
+
+} // namespace
+#endif
+
+TEST(Utilities, CompactCutCells)
+{
+#ifndef AMREX_USE_GPU
+  const int ncell = 48;
+  const amrex::Real r = 30.0;
+  const amrex::Box tbox(
+    amrex::IntVect(AMREX_D_DECL(0, 0, 0)),
+    amrex::IntVect(AMREX_D_DECL(ncell - 1, ncell - 1, ncell - 1)));
+
+  // Original build: count, store and sort the cut cells serially
+  amrex::Real t0 = amrex::second();
+  amrex::Vector<amrex::IntVect> ref;
+  for (amrex::BoxIterator bit(tbox); bit.ok(); ++bit) {
+    if (is_cut(bit(), r)) {
+      ref.push_back(bit());
+    }
+  }
+  const int nref = ref.size();
+  for (int i = 0; i < nref - 1; i++) {
+    for (int j = 0; j < nref - i - 1; j++) {
+      if (ref[j + 1] < ref[j]) {
+        std::swap(ref[j], ref[j + 1]);
+      }
+    }
+  }
+  const amrex::Real t_ref = amrex::second() - t0;
+
+  t0 = amrex::second();
+  const auto lo = amrex::lbound(tbox);
+  const auto len = amrex::length(tbox);
+  auto cell = [=](int n) {
+    return amrex::IntVect(AMREX_D_DECL(
+      lo.x + n % len.x, lo.y + (n / len.x) % len.y,
+      lo.z + n / (len.x * len.y)));
+  };
+  amrex::Gpu::DeviceVector<amrex::IntVect> cut;
+  compact(
+    static_cast<int>(tbox.numPts()), len.x, cut,
+    [=](int n) -> int { return is_cut(cell(n), r) ? 1 : 0; },
+    [=](int n, amrex::IntVect* p) -> int {
+      if (!is_cut(cell(n), r)) {
+        return 0;
+      }
+      *p = cell(n);
+      return 1;
+    });
+  sort(cut);
+  const amrex::Real t_new = amrex::second() - t0;
+
+  ASSERT_EQ(static_cast<int>(cut.size()), nref);
+  for (int i = 0; i < nref; i++) {
+    EXPECT_EQ(cut[i], ref[i]);
+  }
+  amrex::Print() << "Cut cell list of a " << ncell << "^" << AMREX_SPACEDIM
+                 << " tile, " << nref << " cut cells: original " << t_ref
+                 << " s, compacted " << t_new << " s" << std::endl;
+#else
+  GTEST_SKIP();
+#endif
+}
+
+TEST(Utilities, SortUnique)
+{
+#ifndef AMREX_USE_GPU
+  const int n = 1000;
+  amrex::Gpu::DeviceVector<amrex::IntVect> v(n);
+  std::vector<amrex::IntVect> ref(n);
+  for (int i = 0; i < n; i++) {
+    v[i] = amrex::IntVect(AMREX_D_DECL((37 * i) % 11, (13 * i) % 7, i % 3));
+    ref[i] = v[i];
+  }
+  sort(v);
+  std::sort(ref.begin(), ref.end());
+  for (int i = 0; i < n; i++) {
+    EXPECT_EQ(v[i], ref[i]);
+  }
+
+  const amrex::Gpu::DeviceVector<amrex::IntVect> u = unique(v);
+  ref.erase(std::unique(ref.begin(), ref.end()), ref.end());
+  ASSERT_EQ(u.size(), ref.size());
+  for (int i = 0; i < static_cast<int>(u.size()); i++) {
+    EXPECT_EQ(u[i], ref[i]);
+  }
+#else
+  GTEST_SKIP();
+#endif
+}
+
+} // namespace pelec_tests
@@ -0,0 +1,107 @@
+/** \file test-compress.cpp
+ *
+ *  Round trips of the plotfile codecs: exact for the raw and lossless ones,
+ *  within the 32 bit rounding and the tolerance for the float32 and
+ *  quantized ones, and smaller than the raw data for smooth fields
+ */
+
+#include "gtest/gtest.h"
+
+#include "PltCompress.H"
+
+namespace pelec_tests {
+
+namespace {
+
+std::vector<amrex::Real>
+smooth_field(const int n)
+{
+  std::vector<amrex::Real> v(n);
+  for (int i = 0; i < n; i++) {
+    v[i] = 300.0 + 1500.0 * std::exp(-0.001 * (i - n / 2) * (i - n / 2));
+  }
+  return v;
+}
+
+std::vector<amrex::Real>
+round_trip(
+  const std::vector<amrex::Real>& v,
+  const int codec,
+  const amrex::Real tol,
+  std::size_t& nbytes)
+{
+  std::vector<char> enc;
+  pltcompress::encode(v.data(), v.size(), codec, tol, enc);
+  nbytes = enc.size();
+  std::vector<amrex::Real> w(v.size());
+  pltcompress::decode(enc.data(), enc.size(), w.size(), w.data());
+  return w;
+}
+
+} // namespace
+
+TEST(Compress, Names)
+{
+  for (int c = 0; c < pltcompress::num_codec_types; c++) {
+    EXPECT_EQ(pltcompress::codec_from_name(pltcompress::codec_name(c)), c);
+  }
+  EXPECT_EQ(pltcompress::codec_from_name("zfp"), -1);
+}
+
+TEST(Compress, RoundTrip)
+{
+  const int n = 4096;
+  const std::vector<amrex::Real> v = smooth_field(n);
+  const std::size_t nraw = n * sizeof(amrex::Real);
+  std::size_t nbytes = 0;
+
+  std::vector<amrex::Real> w = round_trip(v, pltcompress::raw, 0.0, nbytes);
+  EXPECT_EQ(nbytes, nraw + 1);
+  for (int i = 0; i < n; i++) {
+    EXPECT_EQ(w[i], v[i]);
+  }
+
+  w = round_trip(v, pltcompress::lossless, 0.0, nbytes);
+  EXPECT_LT(nbytes, nraw);
+  for (int i = 0; i < n; i++) {
+    EXPECT_EQ(w[i], v[i]);
+  }
+
+  w = round_trip(v, pltcompress::float32, 0.0, nbytes);
+  EXPECT_EQ(nbytes, nraw / 2 + 1);
+  for (int i = 0; i < n; i++) {
+    EXPECT_NEAR(w[i], v[i], 1.0e-7 * std::abs(v[i]));
+  }
+
+  const amrex::Real tol = 1.0e-3;
+  w = round_trip(v, pltcompress::quantized, tol, nbytes);
+  EXPECT_LT(nbytes, nraw / 4);
+  for (int i = 0; i < n; i++) {
+    EXPECT_LE(std::abs(w[i] - v[i]), tol * (1.0 + 1.0e-12));
+  }
+}
+
+TEST(Compress, Special)
+{
+  // Constant data collapses to runs, values beyond the quantization range
+  // fall back to the lossless codec
+  const int n = 1000;
+  std::size_t nbytes = 0;
+  const std::vector<amrex::Real> c(n, 1.0);
+  std::vector<amrex::Real> w =
+    round_trip(c, pltcompress::lossless, 0.0, nbytes);
+  EXPECT_LT(nbytes, n * sizeof(amrex::Real) / 50);
+  for (int i = 0; i < n; i++) {
+    EXPECT_EQ(w[i], 1.0);
+  }
+
+  std::vector<amrex::Real> v = smooth_field(n);
+  v[n / 3] = 1.0e30;
+  v[n / 2] = -0.0;
+  w = round_trip(v, pltcompress::quantized, 1.0e-6, nbytes);
+  for (int i = 0; i < n; i++) {
+    EXPECT_EQ(w[i], v[i]);
+  }
+}
+
+} // namespace pelec_tests
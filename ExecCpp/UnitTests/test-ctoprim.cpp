@@ -0,0 +1,160 @@
+/** \file test-ctoprim.cpp
+ *
+ *  Checks the fused conserved-to-primitive kernel against the original
+ *  sequence of EOS calls, with the pressure and sound speed from RTY2P and
+ *  RTY2Cs, on a mixture whose composition varies from cell to cell, and
+ *  reports the throughput of both
+ */
+
+#include "gtest/gtest.h"
+#include "AMReX_FArrayBox.H"
+#include "AMReX_Print.H"
+#include "AMReX_Utility.H"
+
+#include "IndexDefines.H"
+#include "EOS.H"
+#include "Utilities.H"
+#include "TestState.H"
+
+namespace pelec_tests {
+
+#ifndef AMREX_USE_GPU
+namespace {
+
+// Conserved-to-primitive conversion with one EOS call per quantity
+void
+ctoprim_reference(
+  const int i,
+  const int j,
+  const int k,
+  amrex::Array4<const amrex::Real> const& u,
+  amrex::Array4<amrex::Real> const& q,
+  amrex::Array4<amrex::Real> const& qa)
+{
+  const amrex::Real rho = u(i, j, k, URHO);
+  const amrex::Real rhoinv = 1.0 / rho;
+  const amrex::Real vx = u(i, j, k, UMX) * rhoinv;
+  const amrex::Real vy = u(i, j, k, UMY) * rhoinv;
+  const amrex::Real vz = u(i, j, k, UMZ) * rhoinv;
+  const amrex::Real kineng = 0.5 * rho * (vx * vx + vy * vy + vz * vz);
+  q(i, j, k, QRHO) = rho;
+  q(i, j, k, QU) = vx;
+  q(i, j, k, QV) = vy;
+  q(i, j, k, QW) = vz;
+  for (int ipassive = 0; ipassive < NPASSIVE; ++ipassive) {
+    const int n = indxmap::upass_map(ipassive);
+    const int nq = indxmap::qpass_map(ipassive);
+    q(i, j, k, nq) = u(i, j, k, n) / rho;
+  }
+
+  const amrex::Real e = (u(i, j, k, UEDEN) - kineng) * rhoinv;
+  amrex::Real T = u(i, j, k, UTEMP);
+  amrex::Real massfrac[NUM_SPECIES];
+  for (int sp = 0; sp < NUM_SPECIES; ++sp)
+    massfrac[sp] = q(i, j, k, sp + QFS);
+  amrex::Real dpdr_e, dpde, gam1, cs, wbar, p;
+
+  EOS::Y2WBAR(massfrac, wbar);
+  EOS::EY2T(e, massfrac, T);
+  EOS::RTY2P(rho, T, massfrac, p);
+  EOS::RTY2Cs(rho, T, massfrac, cs);
+  EOS::TY2G(T, massfrac, gam1);
+  EOS::RPE2dpdr_e(rho, p, e, dpdr_e);
+  EOS::RG2dpde(rho, gam1, dpde);
+
+  q(i, j, k, QTEMP) = T;
+  q(i, j, k, QREINT) = e * rho;
+  q(i, j, k, QPRES) = p;
+  q(i, j, k, QGAME) = p / (e * rho) + 1.0;
+
+  qa(i, j, k, QDPDR) = dpdr_e;
+  qa(i, j, k, QDPDE) = dpde;
+  qa(i, j, k, QGAMC) = gam1;
+  qa(i, j, k, QC) = cs;
+  qa(i, j, k, QCSML) = amrex::max(SMALL, SMALL * cs);
+  qa(i, j, k, QRSPEC) = EOS::RU / wbar;
+}
+
+} // namespace
+#endif
+
+TEST(Hydro, FusedCtoprim)
+{
+#ifndef AMREX_USE_GPU
+  ASSERT_GT(NUM_SPECIES, 1);
+  EOS::init();
+  indxmap::init();
+
+  const int ncell = 32;
+  const amrex::Box bx(
+    amrex::IntVect(AMREX_D_DECL(0, 0, 0)),
+    amrex::IntVect(AMREX_D_DECL(ncell - 1, ncell - 1, ncell - 1)));
+  amrex::FArrayBox ufab(bx, NVAR);
+  amrex::FArrayBox qref(bx, QVAR), qauxref(bx, NQAUX);
+  amrex::FArrayBox qnew(bx, QVAR), qauxnew(bx, NQAUX);
+  // Start the temperature inversion from a poor guess
+  init_state(bx, ufab.array(), 0.8);
+
+  auto const& u = ufab.const_array();
+  const auto lo = amrex::lbound(bx);
+  const auto hi = amrex::ubound(bx);
+  const int nrep = 5;
+
+  auto const& qr = qref.array();
+  auto const& qar = qauxref.array();
+  amrex::Real t0 = amrex::second();
+  for (int rep = 0; rep < nrep; ++rep) {
+    for (int k = lo.z; k <= hi.z; ++k) {
+      for (int j = lo.y; j <= hi.y; ++j) {
+        for (int i = lo.x; i <= hi.x; ++i) {
+          ctoprim_reference(i, j, k, u, qr, qar);
+        }
+      }
+    }
+  }
+  const amrex::Real t_ref = amrex::second() - t0;
+
+  auto const& qn = qnew.array();
+  auto const& qan = qauxnew.array();
+  t0 = amrex::second();
+  for (int rep = 0; rep < nrep; ++rep) {
+    for (int k = lo.z; k <= hi.z; ++k) {
+      for (int j = lo.y; j <= hi.y; ++j) {
+        for (int i = lo.x; i <= hi.x; ++i) {
+          pc_ctoprim(i, j, k, u, qn, qan);
+        }
+      }
+    }
+  }
+  const amrex::Real t_new = amrex::second() - t0;
+
+  const amrex::Real rtol = 1.0e-10;
+  for (int k = lo.z; k <= hi.z; ++k) {
+    for (int j = lo.y; j <= hi.y; ++j) {
+      for (int i = lo.x; i <= hi.x; ++i) {
+        for (int n = 0; n < QVAR; ++n) {
+          EXPECT_NEAR(
+            qn(i, j, k, n), qr(i, j, k, n),
+            rtol * amrex::Math::abs(qr(i, j, k, n)));
+        }
+        for (int n = 0; n < NQAUX; ++n) {
+          EXPECT_NEAR(
+            qan(i, j, k, n), qar(i, j, k, n),
+            rtol * amrex::Math::abs(qar(i, j, k, n)));
+        }
+      }
+    }
+  }
+
+  const amrex::Real ncells = static_cast<amrex::Real>(nrep) * bx.numPts();
+  amrex::Print() << "ctoprim, " << NUM_SPECIES << " species: reference "
+                 << ncells / t_ref << " cells/s, fused " << ncells / t_new
+                 << " cells/s" << std::endl;
+
+  EOS::close();
+#else
+  GTEST_SKIP();
+#endif
+}
+
+} // namespace pelec_tests
@@ -0,0 +1,305 @@
+/** \file test-mol.cpp
+ *
+ *  Checks the fused MOL flux kernel against the original sequence of a slope
+ *  kernel through a dq FAB followed by the face kernel, with the PLM slopes
+ *  and with the two-sided WENO-Z slopes of both faces of each cell, and
+ *  reports the modeled bytes moved per face with the throughput of both
+ */
+
+#include "gtest/gtest.h"
+#include "AMReX_FArrayBox.H"
+#include "AMReX_IArrayBox.H"
+#include "AMReX_Print.H"
+#include "AMReX_Utility.H"
+
+#include "IndexDefines.H"
+#include "EOS.H"
+#include "MOL.H"
+#include "Utilities.H"
+#include "TestState.H"
+
+namespace pelec_tests {
+
+#if !defined(AMREX_USE_GPU) && !defined(PELEC_USE_EB)
+namespace {
+
+// WENO-Z slopes of both faces of cell i as computed before the fusion:
+// dq(n) holds twice the jump to the high face and dq(QVAR + n) twice the jump
+// from the low face. Returns false when the density or pressure of either
+// face would not be positive.
+template <int R>
+bool
+mol_weno_slope_reference(
+  const int i,
+  const int j,
+  const int k,
+  const amrex::GpuArray<const int, 3> bdim,
+  const amrex::GpuArray<const int, 3> q_idx,
+  const amrex::Array4<const amrex::Real>& q,
+  const amrex::Array4<const amrex::Real>& qaux,
+  const amrex::Array4<amrex::Real>& dq)
+{
+  constexpr int W = 2 * R + 1;
+  const amrex::Real rho = q(i, j, k, QRHO);
+  const amrex::Real c = qaux(i, j, k, QC);
+  for (int n = 0; n < 4 + NUM_SPECIES; n++) {
+    amrex::Real v[W];
+    amrex::Real vr[W];
+    for (int m = 0; m < W; m++) {
+      const int ii = i + (m - R) * bdim[0];
+      const int jj = j + (m - R) * bdim[1];
+      const int kk = k + (m - R) * bdim[2];
+      amrex::Real w;
+      if (n < 2) {
+        const amrex::Real sgn = (n == 0) ? -1.0 : 1.0;
+        w = 0.5 * q(ii, jj, kk, QPRES) / c +
+            sgn * 0.5 * rho * q(ii, jj, kk, q_idx[0]);
+      } else if (n < 4) {
+        w = q(ii, jj, kk, q_idx[n - 1]);
+      } else {
+        w = q(ii, jj, kk, QRHO) * q(ii, jj, kk, QFS + n - 4) -
+            q(i, j, k, QFS + n - 4) * q(ii, jj, kk, QPRES) / (c * c);
+      }
+      v[m] = w;
+      vr[W - 1 - m] = w;
+    }
+    dq(i, j, k, n) = 2.0 * (wenoz_face<R>(v) - v[R]);
+    dq(i, j, k, QVAR + n) = 2.0 * (v[R] - wenoz_face<R>(vr));
+  }
+
+  const amrex::Real dpp = dq(i, j, k, 0) + dq(i, j, k, 1);
+  const amrex::Real dpm = dq(i, j, k, QVAR) + dq(i, j, k, QVAR + 1);
+  amrex::Real rhop = 0.0;
+  amrex::Real rhom = 0.0;
+  for (int n = 0; n < NUM_SPECIES; n++) {
+    const amrex::Real Y = q(i, j, k, QFS + n);
+    rhop += rho * Y + 0.5 * (dq(i, j, k, 4 + n) + Y * dpp / c);
+    rhom += rho * Y - 0.5 * (dq(i, j, k, QVAR + 4 + n) + Y * dpm / c);
+  }
+  const amrex::Real p = q(i, j, k, QPRES);
+  return (rhop > 0.0) && (rhom > 0.0) && (p + 0.5 * dpp * c > 0.0) &&
+         (p - 0.5 * dpm * c > 0.0);
+}
+
+// MOL fluxes with the slopes of every cell stored in a dq FAB by a first
+// kernel and read back by the face kernel. With WENO the slopes of the low
+// faces are stored after those of the high faces, and the cells lacking the
+// WENO stencil or failing its positivity check use the PLM slopes for both.
+void
+mol_flux_reference(
+  const amrex::Box& cbox,
+  const amrex::Array4<const amrex::Real>& q,
+  const amrex::Array4<const amrex::Real>& qaux,
+  const amrex::GpuArray<amrex::Array4<amrex::Real>, AMREX_SPACEDIM> flx,
+  const amrex::GpuArray<const amrex::Array4<const amrex::Real>, AMREX_SPACEDIM>
+    a,
+  const int weno_order,
+  const amrex::Box& domain,
+  const amrex::GpuArray<amrex::Array4<const int>, AMREX_SPACEDIM>& bcMask)
+{
+  const int R = weno_order / 2;
+  const int dqm = (weno_order > 0) ? QVAR : 0;
+  const int ndq = QVAR + dqm;
+  for (int dir = 0; dir < AMREX_SPACEDIM; dir++) {
+    amrex::FArrayBox dq_fab(cbox, ndq);
+    auto const& dq = dq_fab.array();
+    setV(cbox, ndq, dq, 0.0);
+
+    const amrex::GpuArray<const int, 3> bdim{dir == 0, dir == 1, dir == 2};
+    const amrex::GpuArray<const int, 3> q_idx{
+      bdim[0] * QU + bdim[1] * QV + bdim[2] * QW,
+      bdim[0] * QV + bdim[1] * QU + bdim[2] * QU,
+      bdim[0] * QW + bdim[1] * QW + bdim[2] * QV};
+    const amrex::GpuArray<const int, 3> f_idx{
+      bdim[0] * UMX + bdim[1] * UMY + bdim[2] * UMZ,
+      bdim[0] * UMY + bdim[1] * UMX + bdim[2] * UMX,
+      bdim[0] * UMZ + bdim[1] * UMZ + bdim[2] * UMY};
+    const int domlo = domain.smallEnd(dir);
+    const int domhi = domain.bigEnd(dir);
+    auto const& bcm = bcMask[dir];
+
+    const amrex::Box wbox = amrex::grow(cbox, dir, -amrex::max(R - 1, 0));
+    amrex::ParallelFor(cbox, [=](int i, int j, int k) noexcept {
+      bool done = false;
+      if (R > 0 && wbox.contains(amrex::IntVect(AMREX_D_DECL(i, j, k)))) {
+        done = (R == 2) ? mol_weno_slope_reference<2>(
+                            i, j, k, bdim, q_idx, q, qaux, dq)
+                        : mol_weno_slope_reference<3>(
+                            i, j, k, bdim, q_idx, q, qaux, dq);
+      }
+      if (!done) {
+        amrex::Real d[QVAR];
+        mol_slope(i, j, k, bdim, q_idx, q, qaux, d);
+        for (int n = 0; n < QVAR; n++) {
+          dq(i, j, k, n) = d[n];
+        }
+        for (int n = 0; n < dqm; n++) {
+          dq(i, j, k, QVAR + n) = d[n];
+        }
+      }
+    });
+
+    const amrex::Box ebox =
+      amrex::surroundingNodes(amrex::grow(cbox, dir, -1), dir);
+    amrex::ParallelFor(ebox, [=](int i, int j, int k) noexcept {
+      amrex::Real dql[QVAR];
+      amrex::Real dqr[QVAR];
+      for (int n = 0; n < QVAR; n++) {
+        dql[n] = dq(i - bdim[0], j - bdim[1], k - bdim[2], n);
+        dqr[n] = dq(i, j, k, dqm + n);
+      }
+      const int idx = bdim[0] * i + bdim[1] * j + bdim[2] * k;
+      const int bc_test_val = pc_bc_test(i, j, k, idx, domlo, domhi, bcm);
+      amrex::Real flux_tmp[NVAR];
+      mol_riemann_flux(
+        i, j, k, bdim, q_idx, f_idx, q, qaux, dql, dqr, bc_test_val, flux_tmp);
+      for (int ivar = 0; ivar < NVAR; ivar++) {
+        flx[dir](i, j, k, ivar) += flux_tmp[ivar] * a[dir](i, j, k);
+      }
+    });
+  }
+}
+
+// Fused fluxes against the reference ones on a smooth state, with the
+// throughput of both
+void
+check_mol_flux(const int weno_order)
+{
+  EOS::init();
+  indxmap::init();
+
+  // Same layout as in getMOLSrcTerm: q on the tile grown by ng, fluxes on
+  // the faces of the tile grown by ng - 1
+  const int ncell = 32;
+  const int ng = 4;
+  const amrex::Box vbox(
+    amrex::IntVect(AMREX_D_DECL(0, 0, 0)),
+    amrex::IntVect(AMREX_D_DECL(ncell - 1, ncell - 1, ncell - 1)));
+  const amrex::Box gbox = amrex::grow(vbox, ng);
+  const amrex::Box cbox = amrex::grow(vbox, ng - 1);
+
+  amrex::FArrayBox ufab(gbox, NVAR), qfab(gbox, QVAR), qauxfab(gbox, NQAUX);
+  init_state(gbox, ufab.array());
+  auto const& u = ufab.const_array();
+  auto const& qa = qfab.array();
+  auto const& qauxa = qauxfab.array();
+  amrex::ParallelFor(gbox, [=](int i, int j, int k) noexcept {
+    pc_ctoprim(i, j, k, u, qa, qauxa);
+  });
+  auto const& q = qfab.const_array();
+  auto const& qaux = qauxfab.const_array();
+
+  amrex::FArrayBox area[AMREX_SPACEDIM], flx_ref[AMREX_SPACEDIM],
+    flx_new[AMREX_SPACEDIM];
+  amrex::IArrayBox mask[AMREX_SPACEDIM];
+  amrex::GpuArray<amrex::Array4<amrex::Real>, AMREX_SPACEDIM> fr, fn;
+  amrex::GpuArray<amrex::Array4<const int>, AMREX_SPACEDIM> bcm;
+  long nface = 0;
+  for (int dir = 0; dir < AMREX_SPACEDIM; dir++) {
+    const amrex::Box ebox = amrex::surroundingNodes(cbox, dir);
+    area[dir].resize(ebox, 1);
+    area[dir].setVal<amrex::RunOn::Host>(1.0);
+    flx_ref[dir].resize(ebox, NVAR);
+    flx_new[dir].resize(ebox, NVAR);
+    mask[dir].resize(amrex::surroundingNodes(gbox, dir), 1);
+    mask[dir].setVal<amrex::RunOn::Host>(0);
+    fr[dir] = flx_ref[dir].array();
+    fn[dir] = flx_new[dir].array();
+    bcm[dir] = mask[dir].const_array();
+    nface += amrex::surroundingNodes(amrex::grow(cbox, dir, -1), dir).numPts();
+  }
+  const amrex::GpuArray<const amrex::Array4<const amrex::Real>, AMREX_SPACEDIM>
+    a{AMREX_D_DECL(
+      area[0].const_array(), area[1].const_array(), area[2].const_array())};
+  const amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> dx{
+    AMREX_D_DECL(1.0, 1.0, 1.0)};
+  const amrex::Box domain = amrex::grow(gbox, 1);
+
+  // The smooth state passes the positivity checks of the WENO slopes in
+  // every cell, where the check of each face by the fused kernel and of both
+  // faces at once by the reference agree
+  const int nrep = 5;
+  amrex::Real t0 = amrex::second();
+  for (int rep = 0; rep < nrep; ++rep) {
+    for (int dir = 0; dir < AMREX_SPACEDIM; dir++) {
+      flx_ref[dir].setVal<amrex::RunOn::Host>(0.0);
+    }
+    mol_flux_reference(cbox, q, qaux, fr, a, weno_order, domain, bcm);
+  }
+  const amrex::Real t_ref = amrex::second() - t0;
+
+  t0 = amrex::second();
+  for (int rep = 0; rep < nrep; ++rep) {
+    for (int dir = 0; dir < AMREX_SPACEDIM; dir++) {
+      flx_new[dir].setVal<amrex::RunOn::Host>(0.0);
+    }
+    pc_compute_hyp_mol_flux(
+      cbox, q, qaux, fn, a, dx, 2, weno_order, domain, bcm);
+  }
+  const amrex::Real t_new = amrex::second() - t0;
+
+  for (int dir = 0; dir < AMREX_SPACEDIM; dir++) {
+    const amrex::Box ebox =
+      amrex::surroundingNodes(amrex::grow(cbox, dir, -1), dir);
+    const auto lo = amrex::lbound(ebox);
+    const auto hi = amrex::ubound(ebox);
+    for (int n = 0; n < NVAR; ++n) {
+      for (int k = lo.z; k <= hi.z; ++k) {
+        for (int j = lo.y; j <= hi.y; ++j) {
+          for (int i = lo.x; i <= hi.x; ++i) {
+            const amrex::Real ref = fr[dir](i, j, k, n);
+            EXPECT_NEAR(
+              fn[dir](i, j, k, n), ref,
+              1.0e-12 * (1.0 + amrex::Math::abs(ref)));
+          }
+        }
+      }
+    }
+  }
+
+  // Modeled DRAM traffic per face, each cell being shared by the faces
+  // around it: q and qaux are read once by each pass that uses them, the
+  // flux is read and written and the area read. The reference also zeroes,
+  // writes and reads back the slopes of each cell, QVAR of them with PLM
+  // and 2 QVAR with WENO.
+  const int ndq = (weno_order > 0) ? 2 * QVAR : QVAR;
+  const amrex::Real word = sizeof(amrex::Real);
+  const amrex::Real common = (QVAR + NQAUX + 2 * NVAR + 1) * word;
+  const amrex::Real b_ref = common + (QVAR + NQAUX + 3 * ndq) * word;
+  const amrex::Real b_new = common;
+  const amrex::Real nf = static_cast<amrex::Real>(nrep) * nface;
+  amrex::Print() << "MOL flux, " << NUM_SPECIES
+                 << " species, mol_weno_order " << weno_order
+                 << ": reference " << b_ref << " B/face, " << nf / t_ref
+                 << " faces/s, " << b_ref * nf / t_ref * 1.0e-9
+                 << " GB/s; fused " << b_new << " B/face, " << nf / t_new
+                 << " faces/s, " << b_new * nf / t_new * 1.0e-9 << " GB/s"
+                 << std::endl;
+
+  EOS::close();
+}
+
+} // namespace
+#endif
+
+TEST(Hydro, FusedMOLFlux)
+{
+#if !defined(AMREX_USE_GPU) && !defined(PELEC_USE_EB)
+  check_mol_flux(0);
+#else
+  GTEST_SKIP();
+#endif
+}
+
+TEST(Hydro, FusedMOLFluxWENO)
+{
+#if !defined(AMREX_USE_GPU) && !defined(PELEC_USE_EB)
+  for (const int weno_order : {5, 7}) {
+    check_mol_flux(weno_order);
+  }
+#else
+  GTEST_SKIP();
+#endif
+}
+
+} // namespace pelec_tests
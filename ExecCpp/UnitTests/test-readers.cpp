@@ -0,0 +1,145 @@
+/** \file test-readers.cpp
+ *
+ *  Checks the binary and CSV input readers against the values written to
+ *  disk and reports their read rate next to the original stream readers
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include "gtest/gtest.h"
+#include "AMReX_Print.H"
+#include "AMReX_Utility.H"
+
+#include "Utilities.H"
+
+namespace pelec_tests {
+
+#ifndef AMREX_USE_GPU
+namespace {
+
+// Original reader, one stream read per double
+void
+read_binary_reference(
+  const std::string& iname, const size_t nval, amrex::Vector<double>& data)
+{
+  std::ifstream infile(iname, std::ios::in | std::ios::binary);
+  for (size_t i = 0; i < nval; i++) {
+    infile.read(reinterpret_cast<char*>(&data[i]), sizeof(data[i]));
+  }
+}
+
+// Original reader, one string stream per value
+void
+read_csv_reference(const std::string& iname, amrex::Vector<double>& data)
+{
+  std::ifstream infile(iname, std::ios::in);
+  std::stringstream ss;
+  ss << infile.rdbuf();
+  std::istringstream iss(ss.str());
+  std::string line;
+  std::getline(iss, line);
+  int cnt = 0;
+  while (std::getline(iss, line)) {
+    std::istringstream linestream(line);
+    std::string value;
+    while (getline(linestream, value, ',')) {
+      std::istringstream sinput(value);
+      sinput >> data[cnt];
+      cnt++;
+    }
+  }
+}
+
+amrex::Real
+value(const size_t i)
+{
+  return std::sin(0.37 * i) * 1.0e-3 * (1 + i % 7);
+}
+
+} // namespace
+#endif
+
+TEST(Utilities, Readers)
+{
+#ifndef AMREX_USE_GPU
+  const size_t n = 24;
+  const size_t ncol = 6;
+  const size_t nval = n * n * n * ncol;
+  const std::string bname = "test-readers.bin";
+  const std::string cname = "test-readers.csv";
+
+  {
+    std::ofstream ofs(bname, std::ios::out | std::ios::binary);
+    for (size_t i = 0; i < nval; i++) {
+      const double v = value(i);
+      ofs.write(reinterpret_cast<const char*>(&v), sizeof(v));
+    }
+  }
+  {
+    std::ofstream ofs(cname, std::ios::out);
+    ofs << "x,y,z,u,v,w\n";
+    ofs.precision(17);
+    for (size_t i = 0; i < nval; i += ncol) {
+      for (size_t c = 0; c < ncol; c++) {
+        ofs << value(i + c) << ((c + 1 < ncol) ? "," : "\n");
+      }
+    }
+  }
+
+  amrex::Vector<double> ref(nval), data(nval);
+
+  amrex::Real t0 = amrex::second();
+  read_binary_reference(bname, nval, ref);
+  const amrex::Real t_bref = amrex::second() - t0;
+  t0 = amrex::second();
+  read_binary(bname, n, n, n, ncol, data);
+  const amrex::Real t_bin = amrex::second() - t0;
+  for (size_t i = 0; i < nval; i++) {
+    EXPECT_EQ(data[i], ref[i]);
+    EXPECT_EQ(data[i], value(i));
+  }
+
+  // In place, summed so that every value is read
+  t0 = amrex::second();
+  const BinaryView view(bname, n, n, n, ncol);
+  double sum = 0.0;
+  for (size_t i = 0; i < nval; i++) {
+    sum += view[i];
+  }
+  const amrex::Real t_view = amrex::second() - t0;
+  EXPECT_NE(sum, 0.0);
+  EXPECT_EQ(view.size(), nval);
+  for (size_t i = 0; i < nval; i++) {
+    EXPECT_EQ(view[i], ref[i]);
+  }
+
+  t0 = amrex::second();
+  read_csv_reference(cname, ref);
+  const amrex::Real t_cref = amrex::second() - t0;
+  std::fill(data.begin(), data.end(), 0.0);
+  t0 = amrex::second();
+  read_csv(cname, n, n, n, data);
+  const amrex::Real t_csv = amrex::second() - t0;
+  for (size_t i = 0; i < nval; i++) {
+    EXPECT_EQ(data[i], ref[i]);
+  }
+
+  const amrex::Real mval = 1.0e-6 * nval;
+  amrex::Print() << "read_binary: reference " << mval / t_bref
+                 << " Mvalues/s, mapped " << mval / t_bin
+                 << " Mvalues/s, in place " << mval / t_view << " Mvalues/s"
+                 << std::endl;
+  amrex::Print() << "read_csv: reference " << mval / t_cref
+                 << " Mvalues/s, single pass " << mval / t_csv
+                 << " Mvalues/s" << std::endl;
+
+  std::remove(bname.c_str());
+  std::remove(cname.c_str());
+#else
+  GTEST_SKIP();
+#endif
+}
+
+} // namespace pelec_tests
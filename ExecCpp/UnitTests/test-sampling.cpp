@@ -0,0 +1,96 @@
+/** \file test-sampling.cpp
+ *
+ *  Checks the points generated for the sampled lines and planes, and that
+ *  the interpolation onto the sample points is exact for linear fields
+ */
+
+#include "gtest/gtest.h"
+#include "AMReX_FArrayBox.H"
+
+#include "Sampling.H"
+
+namespace pelec_tests {
+
+TEST(Sampling, Points)
+{
+  const amrex::Real start[3] = {0.0, 1.0, 2.0};
+  const amrex::Real end[3] = {1.0, 3.0, 2.0};
+  SampleSet line;
+  sample_line_points(start, end, 5, line);
+  EXPECT_EQ(line.num_points(), 5);
+  for (int d = 0; d < AMREX_SPACEDIM; d++) {
+    EXPECT_EQ(line.x[d], start[d]);
+    EXPECT_EQ(line.x[4 * AMREX_SPACEDIM + d], end[d]);
+    EXPECT_NEAR(
+      line.x[AMREX_SPACEDIM + d], 0.75 * start[d] + 0.25 * end[d], 1.0e-15);
+  }
+
+  const amrex::Real axis1[3] = {1.0, 0.0, 0.0};
+  const amrex::Real axis2[3] = {0.0, 0.0, 2.0};
+  const int n[2] = {3, 4};
+  SampleSet plane;
+  sample_plane_points(start, axis1, axis2, n, plane);
+  EXPECT_EQ(plane.num_points(), 12);
+  const amrex::Real* last = &plane.x[11 * AMREX_SPACEDIM];
+  for (int d = 0; d < AMREX_SPACEDIM; d++) {
+    EXPECT_NEAR(last[d], start[d] + axis1[d] + axis2[d], 1.0e-15);
+  }
+}
+
+TEST(Sampling, Interpolation)
+{
+#ifndef AMREX_USE_GPU
+  const int ncell = 8;
+  const amrex::Box bx(
+    amrex::IntVect(AMREX_D_DECL(-1, -1, -1)),
+    amrex::IntVect(AMREX_D_DECL(ncell, ncell, ncell)));
+  const amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> plo{
+    AMREX_D_DECL(-1.0, 0.0, 2.0)};
+  const amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> dx{
+    AMREX_D_DECL(0.5, 0.25, 1.0)};
+  amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> dxinv;
+  for (int d = 0; d < AMREX_SPACEDIM; d++) {
+    dxinv[d] = 1.0 / dx[d];
+  }
+
+  // Linear field of the cell centers
+  const amrex::Real a[3] = {1.5, -2.0, 0.7};
+  auto field = [&](const amrex::Real* x) {
+    amrex::Real f = 3.0;
+    for (int d = 0; d < AMREX_SPACEDIM; d++) {
+      f += a[d] * x[d];
+    }
+    return f;
+  };
+  amrex::FArrayBox fab(bx, 1);
+  auto const& q = fab.array();
+  const auto lo = amrex::lbound(bx);
+  const auto hi = amrex::ubound(bx);
+  for (int k = lo.z; k <= hi.z; k++) {
+    for (int j = lo.y; j <= hi.y; j++) {
+      for (int i = lo.x; i <= hi.x; i++) {
+        const int iv[3] = {i, j, k};
+        amrex::Real x[AMREX_SPACEDIM];
+        for (int d = 0; d < AMREX_SPACEDIM; d++) {
+          x[d] = plo[d] + (iv[d] + 0.5) * dx[d];
+        }
+        q(i, j, k) = field(x);
+      }
+    }
+  }
+
+  for (int p = 0; p < 50; p++) {
+    amrex::Real x[AMREX_SPACEDIM];
+    for (int d = 0; d < AMREX_SPACEDIM; d++) {
+      x[d] = plo[d] + ncell * dx[d] * std::fmod(0.137 * (p + 1) * (d + 3), 1.0);
+    }
+    EXPECT_NEAR(
+      pc_sample_interp(x, plo, dxinv, fab.const_array(), 0), field(x),
+      1.0e-12);
+  }
+#else
+  GTEST_SKIP();
+#endif
+}
+
+} // namespace pelec_tests
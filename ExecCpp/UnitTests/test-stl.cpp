@@ -0,0 +1,247 @@
+/** \file test-stl.cpp
+ *
+ *  Checks the STL reader and the distance and inside tests of the STL
+ *  implicit function on a faceted sphere against the brute force loop over
+ *  the triangles and the exact sphere, and reports the time to evaluate it
+ *  on the nodes of a grid with and without the hierarchy
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "AMReX_Print.H"
+#include "AMReX_Utility.H"
+
+#include "StlGeometry.H"
+
+namespace pelec_tests {
+
+namespace {
+
+StlPoint
+on_sphere(const StlPoint& a, const StlPoint& b)
+{
+  StlPoint m = {a[0] + b[0], a[1] + b[1], a[2] + b[2]};
+  const amrex::Real r = std::sqrt(m[0] * m[0] + m[1] * m[1] + m[2] * m[2]);
+  for (int d = 0; d < 3; d++) {
+    m[d] /= r;
+  }
+  return m;
+}
+
+// Unit sphere from an icosahedron whose triangles are split in four nsub
+// times, the vertices shared by the neighbour triangles being identical
+std::vector<StlTriangle>
+icosphere(const int nsub)
+{
+  const amrex::Real t = 0.5 * (1.0 + std::sqrt(5.0));
+  const StlPoint z = {0.0, 0.0, 0.0};
+  std::vector<StlPoint> v = {
+    {-1, t, 0}, {1, t, 0}, {-1, -t, 0}, {1, -t, 0}, {0, -1, t}, {0, 1, t},
+    {0, -1, -t}, {0, 1, -t}, {t, 0, -1}, {t, 0, 1}, {-t, 0, -1}, {-t, 0, 1}};
+  for (auto& p : v) {
+    p = on_sphere(p, z);
+  }
+  const int f[20][3] = {
+    {0, 11, 5}, {0, 5, 1},  {0, 1, 7},   {0, 7, 10}, {0, 10, 11},
+    {1, 5, 9},  {5, 11, 4}, {11, 10, 2}, {10, 7, 6}, {7, 1, 8},
+    {3, 9, 4},  {3, 4, 2},  {3, 2, 6},   {3, 6, 8},  {3, 8, 9},
+    {4, 9, 5},  {2, 4, 11}, {6, 2, 10},  {8, 6, 7},  {9, 8, 1}};
+  std::vector<StlTriangle> tris(20);
+  for (int i = 0; i < 20; i++) {
+    for (int iv = 0; iv < 3; iv++) {
+      tris[i].v[iv] = v[f[i][iv]];
+    }
+  }
+  for (int s = 0; s < nsub; s++) {
+    std::vector<StlTriangle> sub;
+    for (const auto& tri : tris) {
+      const StlPoint ab = on_sphere(tri.v[0], tri.v[1]);
+      const StlPoint bc = on_sphere(tri.v[1], tri.v[2]);
+      const StlPoint ca = on_sphere(tri.v[2], tri.v[0]);
+      sub.push_back({{tri.v[0], ab, ca}});
+      sub.push_back({{ab, tri.v[1], bc}});
+      sub.push_back({{ca, bc, tri.v[2]}});
+      sub.push_back({{ab, bc, ca}});
+    }
+    tris.swap(sub);
+  }
+  return tris;
+}
+
+amrex::Real
+brute_force_distance(const StlPoint& p, const std::vector<StlTriangle>& tris)
+{
+  amrex::Real best = std::numeric_limits<amrex::Real>::max();
+  for (const auto& t : tris) {
+    best = std::min(best, stl_triangle_dist2(p, t));
+  }
+  return std::sqrt(best);
+}
+
+amrex::Real
+radius(const StlPoint& p)
+{
+  return std::sqrt(p[0] * p[0] + p[1] * p[1] + p[2] * p[2]);
+}
+
+} // namespace
+
+TEST(StlGeometry, Reader)
+{
+  const std::vector<StlTriangle> tris = icosphere(1);
+  const std::string aname = "test-stl-ascii.stl";
+  const std::string bname = "test-stl-binary.stl";
+  {
+    std::ofstream ofs(aname, std::ios::out);
+    ofs.precision(9);
+    ofs << "solid sphere\n";
+    for (const auto& t : tris) {
+      ofs << "  facet normal 0 0 0\n    outer loop\n";
+      for (int iv = 0; iv < 3; iv++) {
+        ofs << "      vertex " << t.v[iv][0] << ' ' << t.v[iv][1] << ' '
+            << t.v[iv][2] << '\n';
+      }
+      ofs << "    endloop\n  endfacet\n";
+    }
+    ofs << "endsolid sphere\n";
+  }
+  {
+    std::ofstream ofs(bname, std::ios::out | std::ios::binary);
+    const std::string header(80, ' ');
+    ofs.write(header.data(), header.size());
+    const std::uint32_t n = tris.size();
+    ofs.write(reinterpret_cast<const char*>(&n), sizeof(n));
+    for (const auto& t : tris) {
+      float f[12] = {0.0f};
+      for (int iv = 0; iv < 3; iv++) {
+        for (int d = 0; d < 3; d++) {
+          f[3 + 3 * iv + d] = static_cast<float>(t.v[iv][d]);
+        }
+      }
+      const std::uint16_t attr = 0;
+      ofs.write(reinterpret_cast<const char*>(f), sizeof(f));
+      ofs.write(reinterpret_cast<const char*>(&attr), sizeof(attr));
+    }
+  }
+
+  for (const auto& fname : {aname, bname}) {
+    std::ifstream ifs(fname, std::ios::in | std::ios::binary);
+    const std::string buf(
+      (std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+    const std::vector<StlTriangle> read = read_stl(buf.data(), buf.size());
+    ASSERT_EQ(read.size(), tris.size());
+    for (std::size_t i = 0; i < tris.size(); i++) {
+      for (int iv = 0; iv < 3; iv++) {
+        for (int d = 0; d < 3; d++) {
+          EXPECT_NEAR(read[i].v[iv][d], tris[i].v[iv][d], 1e-6);
+        }
+      }
+    }
+
+    // Twice as large, centered on (1, 0, 0)
+    const StlIF stl(fname, 2.0, {1.0, 0.0, 0.0}, false);
+    EXPECT_EQ(stl.numTriangles(), static_cast<int>(tris.size()));
+    EXPECT_TRUE(stl.inside({1.5, 0.0, 0.0}));
+    EXPECT_FALSE(stl.inside({-1.5, 0.0, 0.0}));
+  }
+  std::remove(aname.c_str());
+  std::remove(bname.c_str());
+}
+
+TEST(StlGeometry, Sphere)
+{
+  const std::vector<StlTriangle> tris = icosphere(4);
+  const StlIF stl(tris, false);
+  const StlIF stl_fluid_inside(tris, true);
+
+  // The facets are within 2e-3 of the sphere for 4 subdivisions
+  const amrex::Real tol = 2e-3;
+  std::mt19937 gen(42);
+  std::uniform_real_distribution<amrex::Real> coord(-1.5, 1.5);
+  for (int n = 0; n < 2000; n++) {
+    const StlPoint p = {coord(gen), coord(gen), coord(gen)};
+    const amrex::Real r = radius(p);
+    const amrex::Real d = stl.distance(p);
+    EXPECT_NEAR(d, brute_force_distance(p, tris), 1e-12);
+    EXPECT_NEAR(d, std::abs(r - 1.0), tol);
+    if (std::abs(r - 1.0) > tol) {
+      EXPECT_EQ(stl.inside(p), r < 1.0);
+#if AMREX_SPACEDIM == 3
+      const amrex::RealArray q = {p[0], p[1], p[2]};
+      EXPECT_EQ(stl(q) > 0.0, r < 1.0);
+      EXPECT_EQ(stl_fluid_inside(q) > 0.0, r > 1.0);
+#endif
+    }
+  }
+
+  // Rays along x through the vertices of the facets
+  std::map<StlPoint, int> vertices;
+  for (const auto& t : tris) {
+    for (int iv = 0; iv < 3; iv++) {
+      vertices[t.v[iv]]++;
+    }
+  }
+  for (const auto& v : vertices) {
+    if (std::abs(v.first[0]) > 0.2) {
+      EXPECT_TRUE(stl.inside({0.0, v.first[1], v.first[2]}));
+      EXPECT_FALSE(stl.inside({-1.5, v.first[1], v.first[2]}));
+    }
+  }
+}
+
+TEST(StlGeometry, Timing)
+{
+  const std::vector<StlTriangle> tris = icosphere(6);
+  amrex::Real t0 = amrex::second();
+  const StlIF stl(tris, false);
+  const amrex::Real t_bvh = amrex::second() - t0;
+
+  // Implicit function on the nodes of a 32^3 grid around the sphere
+  const int n = 32;
+  const amrex::Real h = 3.0 / n;
+  t0 = amrex::second();
+  int ninside = 0;
+  for (int k = 0; k <= n; k++) {
+    for (int j = 0; j <= n; j++) {
+      for (int i = 0; i <= n; i++) {
+        const StlPoint p = {-1.5 + i * h, -1.5 + j * h, -1.5 + k * h};
+        if (stl.distance(p) > 0.0 && stl.inside(p)) {
+          ninside++;
+        }
+      }
+    }
+  }
+  const amrex::Real t_grid = amrex::second() - t0;
+  EXPECT_GT(ninside, 0);
+
+  // Brute force distance on one line of the grid, timed apart from the
+  // comparison
+  std::vector<amrex::Real> d_brute(n + 1);
+  t0 = amrex::second();
+  for (int i = 0; i <= n; i++) {
+    const StlPoint p = {-1.5 + i * h, 0.0, 0.0};
+    d_brute[i] = brute_force_distance(p, tris);
+  }
+  const amrex::Real t_brute = (amrex::second() - t0) * (n + 1) * (n + 1);
+  for (int i = 0; i <= n; i++) {
+    const StlPoint p = {-1.5 + i * h, 0.0, 0.0};
+    EXPECT_NEAR(d_brute[i], stl.distance(p), 1e-12);
+  }
+
+  amrex::Print() << "STL sphere, " << stl.numTriangles()
+                 << " triangles: hierarchy built in " << t_bvh << " s, "
+                 << (n + 1) * (n + 1) * (n + 1) << " nodes in " << t_grid
+                 << " s, brute force distance estimate " << t_brute
+                 << " s, speed-up " << t_brute / (t_bvh + t_grid) << std::endl;
+}
+
+} // namespace pelec_tests
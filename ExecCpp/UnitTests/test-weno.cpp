@@ -0,0 +1,75 @@
+/** \file test-weno.cpp
+ *
+ *  Checks the order of the WENO-Z face reconstructions on a smooth profile
+ *  and their boundedness across a jump
+ */
+
+#include <cmath>
+
+#include "gtest/gtest.h"
+
+#include "WENO.H"
+
+namespace pelec_tests {
+
+namespace {
+
+// Max error at the faces i+1/2 for the cell averages of sin(2 pi x) on n
+// periodic cells
+template <int R>
+amrex::Real
+face_error(const int n)
+{
+  const amrex::Real pi = 3.14159265358979323846;
+  const amrex::Real h = 1.0 / n;
+  amrex::Real err = 0.0;
+  for (int i = 0; i < n; i++) {
+    amrex::Real v[2 * R + 1];
+    for (int m = -R; m <= R; m++) {
+      const amrex::Real x0 = (i + m) * h;
+      v[m + R] = (std::cos(2.0 * pi * x0) - std::cos(2.0 * pi * (x0 + h))) /
+                 (2.0 * pi * h);
+    }
+    const amrex::Real exact = std::sin(2.0 * pi * (i + 1) * h);
+    err = std::max(err, std::abs(wenoz_face<R>(v) - exact));
+  }
+  return err;
+}
+
+template <int R>
+void
+check_weno()
+{
+  // Design order 2R+1 on a smooth profile
+  const amrex::Real e1 = face_error<R>(32);
+  const amrex::Real e2 = face_error<R>(64);
+  EXPECT_GT(std::log2(e1 / e2), 2 * R + 1 - 0.2);
+
+  // No new extrema next to a jump, from either side
+  for (int s = 0; s <= 2 * R; s++) {
+    amrex::Real v[2 * R + 1];
+    amrex::Real vr[2 * R + 1];
+    for (int m = 0; m <= 2 * R; m++) {
+      v[m] = (m < s) ? 0.0 : 1.0;
+      vr[2 * R - m] = v[m];
+    }
+    for (const amrex::Real f : {wenoz_face<R>(v), wenoz_face<R>(vr)}) {
+      EXPECT_GT(f, -1.0e-2);
+      EXPECT_LT(f, 1.0 + 1.0e-2);
+    }
+  }
+}
+
+} // namespace
+
+TEST(WENO, Order5)
+{
+  check_weno<2>();
+}
+
+TEST(WENO, Order7)
+{
+  check_weno<3>();
+}
+
+} // namespace pelec_tests
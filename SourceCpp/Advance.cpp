@@ -33,6 +33,10 @@ PeleC::advance(
     }
   }
 
+  // The state may have been changed by the reflux, average down or regrid
+  // since the last step
+  invalidatePrimCache();
+
   amrex::Real dt_new = dt;
   if (do_mol) {
     dt_new = do_mol_advance(time, dt, amr_iteration, amr_ncycle);
@@ -40,6 +44,8 @@ PeleC::advance(
     dt_new = do_sdc_advance(time, dt, amr_iteration, amr_ncycle);
   }
 
+  invalidatePrimCache();
+
   return dt_new;
 }
 
@@ -86,12 +92,13 @@ PeleC::do_mol_advance(
   set_body_state(U_old);
   set_body_state(U_new);
 #endif
+  invalidatePrimCache();
 
   // Compute S^{n} = MOLRhs(U^{n})
   if (verbose) {
     amrex::Print() << "... Computing MOL source term at t^{n} " << std::endl;
   }
-  FillPatch(*this, Sborder, nGrowTr, time, State_Type, 0, NVAR);
+  fillSborder(time, nGrowTr);
   amrex::Real flux_factor = 0;
   getMOLSrcTerm(Sborder, S, time, dt, flux_factor);
 
@@ -124,12 +131,13 @@ PeleC::do_mol_advance(
 #endif
 
   computeTemp(U_new, 0);
+  invalidatePrimCache();
 
   // Compute S^{n+1} = MOLRhs(U^{n+1,*})
   if (verbose) {
     amrex::Print() << "... Computing MOL source term at t^{n+1} " << std::endl;
   }
-  FillPatch(*this, Sborder, nGrowTr, time + dt, State_Type, 0, NVAR);
+  fillSborder(time + dt, nGrowTr);
   flux_factor = mol_iters > 1 ? 0 : 1;
   getMOLSrcTerm(Sborder, S, time, dt, flux_factor);
 
@@ -171,6 +179,7 @@ PeleC::do_mol_advance(
 #endif
 
   computeTemp(U_new, 0);
+  invalidatePrimCache();
 
 #ifdef PELEC_USE_REACTIONS
   if (do_react == 1) {
@@ -179,7 +188,7 @@ PeleC::do_mol_advance(
         amrex::Print() << "... Re-computing MOL source term at t^{n+1} (iter = "
                        << mol_iter << " of " << mol_iters << ")" << std::endl;
       }
-      FillPatch(*this, Sborder, nGrowTr, time + dt, State_Type, 0, NVAR);
+      fillSborder(time + dt, nGrowTr);
       flux_factor = mol_iter == mol_iters ? 1 : 0;
       getMOLSrcTerm(Sborder, S_new, time, dt, flux_factor);
 
@@ -190,6 +199,7 @@ PeleC::do_mol_advance(
       react_state(time, dt, false, &S);
 
       computeTemp(U_new, 0);
+      invalidatePrimCache();
     }
   }
 #endif
@@ -323,6 +333,7 @@ PeleC::do_sdc_iteration(
 
   initialize_sdc_iteration(
     time, dt, amr_iteration, amr_ncycle, sub_iteration, sub_ncycle);
+  invalidatePrimCache();
 
   // Create Sborder if hydro or diffuse, with the appropriate number of grow
   // cells
@@ -365,7 +376,7 @@ PeleC::do_sdc_iteration(
 #endif
 
   if (fill_Sborder) {
-    FillPatch(*this, Sborder, nGrow_Sborder, time, State_Type, 0, NVAR);
+    fillSborder(time, nGrow_Sborder);
   }
 
   if (sub_iteration == 0) {
@@ -504,6 +515,7 @@ PeleC::do_sdc_iteration(
 
   int ng_src = 0;
   computeTemp(S_new, ng_src);
+  invalidatePrimCache();
 
   // Now update t_new sources (diffusion separate because it requires a fill
   // patch)
@@ -512,7 +524,7 @@ PeleC::do_sdc_iteration(
       amrex::Print() << "... Computing diffusion terms at t^(n+1,"
                      << sub_iteration + 1 << ")" << std::endl;
     }
-    FillPatch(*this, Sborder, nGrowTr, time + dt, State_Type, 0, NVAR);
+    fillSborder(time + dt, nGrowTr);
     amrex::Real flux_factor_new = sub_iteration == sub_ncycle - 1 ? 0.5 : 0;
     getMOLSrcTerm(Sborder, *new_sources[diff_src], time, dt, flux_factor_new);
   }
@@ -538,7 +550,7 @@ PeleC::do_sdc_iteration(
       amrex::Print() << "moveKick ... updating velocity only\n";
 
     if (!do_diffuse) { // Else, this was already done above.  No need to redo
-      FillPatch(*this, Sborder, nGrow_Sborder, time + dt, State_Type, 0, NVAR);
+      fillSborder(time + dt, nGrow_Sborder);
     }
 
     new_sources[spray_src]->setVal(0.);
@@ -571,6 +583,7 @@ PeleC::do_sdc_iteration(
 #endif
 
   computeTemp(S_new, ng_src);
+  invalidatePrimCache();
 
   finalize_sdc_iteration(
     time, dt, amr_iteration, amr_ncycle, sub_iteration, sub_ncycle);
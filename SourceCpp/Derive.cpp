@@ -327,50 +327,15 @@ pc_derenstrophy(
 {
   // This routine will derive enstrophy  = 1/2 rho (x_vorticity^2 +
   // y_vorticity^2 + z_vorticity^2)
-  auto const dat = datfab.array();
+  auto const dat = datfab.const_array();
   auto enstrophy = derfab.array();
 
-  const amrex::Box& gbx = amrex::grow(bx, 1);
-
-  amrex::FArrayBox local(gbx, 3);
-  amrex::Elixir local_eli = local.elixir();
-  auto larr = local.array();
-
-  // Convert momentum to velocity.
-  amrex::ParallelFor(gbx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-    const amrex::Real rhoInv = 1.0 / dat(i, j, k, URHO);
-    larr(i, j, k, 0) = dat(i, j, k, UMX) * rhoInv;
-    larr(i, j, k, 1) = dat(i, j, k, UMY) * rhoInv;
-    larr(i, j, k, 2) = dat(i, j, k, UMZ) * rhoInv;
-  });
-
   AMREX_D_TERM(const amrex::Real dx = geomdata.CellSize(0);
                , const amrex::Real dy = geomdata.CellSize(1);
                , const amrex::Real dz = geomdata.CellSize(2););
 
-  // Calculate enstrophy.
   amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-    AMREX_D_TERM(enstrophy(i, j, k) = 0.;
-                 , const amrex::Real vx =
-                     0.5 * (larr(i + 1, j, k, 1) - larr(i - 1, j, k, 1)) / dx;
-                 const amrex::Real uy =
-                   0.5 * (larr(i, j + 1, k, 0) - larr(i, j - 1, k, 0)) / dy;
-                 const amrex::Real v3 = vx - uy;
-                 , const amrex::Real wx =
-                     0.5 * (larr(i + 1, j, k, 2) - larr(i - 1, j, k, 2)) / dx;
-
-                 const amrex::Real wy =
-                   0.5 * (larr(i, j + 1, k, 2) - larr(i, j - 1, k, 2)) / dy;
-
-                 const amrex::Real uz =
-                   0.5 * (larr(i, j, k + 1, 0) - larr(i, j, k - 1, 0)) / dz;
-                 const amrex::Real vz =
-                   0.5 * (larr(i, j, k + 1, 1) - larr(i, j, k - 1, 1)) / dz;
-
-                 const amrex::Real v1 = wy - vz;
-                 const amrex::Real v2 = uz - wx;);
-    enstrophy(i, j, k) = 0.5 * dat(i, j, k, URHO) *
-                         (AMREX_D_TERM(0., +v3 * v3, +v1 * v1 + v2 * v2));
+    enstrophy(i, j, k) = pc_enstrophy(i, j, k, dat, AMREX_D_DECL(dx, dy, dz));
   });
 }
 
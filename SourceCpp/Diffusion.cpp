@@ -97,15 +97,23 @@ PeleC::getMOLSrcTerm(
 
   const bool as_crse = (fr_as_crse != nullptr);
   const bool as_fine = (fr_as_fine != nullptr);
+
+  // The state redistribution leaves the reredistribution data of the flux
+  // registers at zero
+  const bool state_redist = (eb_redistribution_type == "StateRedist");
 #endif
 
+  // Primitive state shared with the other operators of the stage
+  const PrimCache* pcache =
+    (use_prim_cache && Sborder_from_cache && &S == &Sborder &&
+     prim_cache.hasCoeffs())
+      ? &prim_cache
+      : nullptr;
+
 #ifdef _OPENMP
 #pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
 #endif
   {
-    // amrex::IArrayBox bcMask[AMREX_SPACEDIM];
-
-    int flag_nscbc_isAnyPerio = (geom.isAnyPeriodic()) ? 1 : 0;
     int flag_nscbc_perio[AMREX_SPACEDIM]; // For 3D, we will know which corners
                                           // have a periodicity
     for (int dir = 0; dir < AMREX_SPACEDIM; ++dir) {
@@ -154,76 +162,85 @@ PeleC::getMOLSrcTerm(
       const int* hi = vbox.hiVect();
 
       BL_PROFILE_VAR_START(diff);
-      int nqaux = NQAUX > 0 ? NQAUX : 1;
-      amrex::FArrayBox q(gbox, QVAR), qaux(gbox, nqaux),
-        coeff_cc(gbox, nCompTr);
-      amrex::Elixir qeli = q.elixir();
-      amrex::Elixir qauxeli = qaux.elixir();
-      amrex::Elixir coefeli = coeff_cc.elixir();
-      auto const& s = S.array(mfi);
-      auto const& qar = q.array();
-      auto const& qauxar = qaux.array();
-
-      // Get primitives, Q, including (Y, T, p, rho) from conserved state
-      // required for D term
-      {
-        BL_PROFILE("PeleC::ctoprim()");
-        amrex::ParallelFor(
-          gbox, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-            pc_ctoprim(i, j, k, s, qar, qauxar);
-          });
-      }
-// TODO deal with NSCBC
-#if 0       
-      for (int dir = 0; dir < AMREX_SPACEDIM ; dir++)  {
-        const amrex::Box& bxtmp = amrex::surroundingNodes(vbox,dir);
-        amrex::Box TestBox(bxtmp);
-        for(int d=0; d<AMREX_SPACEDIM; ++d) {
-          if (dir!=d) TestBox.grow(d,1);
+
+      // Characteristic BCs on the "UserBC" faces, see Hydro.cpp
+      const bool nscbc_tile =
+        ((do_hydro && do_mol && nscbc_adv == 1) || nscbc_diff == 1) &&
+        pc_nscbc_needed(gbox, geom.Domain(), phys_bc.lo(), phys_bc.hi());
+
+      // The primitives and transport coefficients come from the level cache
+      // when S was filled through it, except on the tiles where the NSCBC
+      // rewrites the ghost cells of Q
+      const bool from_cache = (pcache != nullptr) && !nscbc_tile;
+      amrex::Array4<const amrex::Real> qar, qauxar, coe_cc;
+      amrex::FArrayBox q, qaux, coeff_cc;
+      amrex::Elixir qeli, qauxeli, coefeli;
+      amrex::IArrayBox bcMask[AMREX_SPACEDIM];
+      amrex::Elixir bcMask_eli[AMREX_SPACEDIM];
+      amrex::GpuArray<amrex::Array4<const int>, AMREX_SPACEDIM> bcm;
+      if (from_cache) {
+        qar = pcache->q().const_array(mfi);
+        qauxar = pcache->qaux().const_array(mfi);
+        coe_cc = pcache->coeffs().const_array(mfi);
+      } else {
+        int nqaux = NQAUX > 0 ? NQAUX : 1;
+        q.resize(gbox, QVAR);
+        qaux.resize(gbox, nqaux);
+        coeff_cc.resize(gbox, nCompTr);
+        qeli = q.elixir();
+        qauxeli = qaux.elixir();
+        coefeli = coeff_cc.elixir();
+        auto const& qarr = q.array();
+        auto const& qauxarr = qaux.array();
+
+        // Get primitives, Q, including (Y, T, p, rho) from conserved state
+        // required for D term
+        if (pcache != nullptr) {
+          q.copy<amrex::RunOn::Device>(pcache->q()[mfi], gbox);
+          qaux.copy<amrex::RunOn::Device>(pcache->qaux()[mfi], gbox);
+        } else {
+          BL_PROFILE("PeleC::ctoprim()");
+          auto const& s = S.array(mfi);
+          amrex::ParallelFor(
+            gbox, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+              pc_ctoprim(i, j, k, s, qarr, qauxarr);
+            });
         }
-        
-        bcMask[dir].resize(TestBox,1);
-        bcMask[dir].setVal(0);
-	    }
-      
-      // Becase bcMask is read in the Riemann solver in any case,
-      // here we put physbc values in the appropriate faces for the non-nscbc case
-      set_bc_mask(lo, hi, domain_lo, domain_hi,
-                  AMREX_D_DECL(AMREX_TO_FORTRAN(bcMask[0]),
-	                       AMREX_TO_FORTRAN(bcMask[1]),
-                         AMREX_TO_FORTRAN(bcMask[2])));
-
-      if (nscbc_diff == 1)
-      {
-        impose_NSCBC(lo, hi, domain_lo, domain_hi,
-                     AMREX_TO_FORTRAN(Sfab),
-                     AMREX_TO_FORTRAN(q.fab()),
-                     AMREX_TO_FORTRAN(qaux.fab()),
-                     AMREX_D_DECL(AMREX_TO_FORTRAN(bcMask[0]),
-                            AMREX_TO_FORTRAN(bcMask[1]),
-                            AMREX_TO_FORTRAN(bcMask[2])),
-                     &flag_nscbc_isAnyPerio, flag_nscbc_perio, 
-                     &time, dx, &dt);
-      }
-#endif
 
-      // Compute transport coefficients, coincident with Q
-      auto const& coe_cc = coeff_cc.array();
-      {
-        auto const& qar_yin = q.array(QFS);
-        auto const& qar_Tin = q.array(QTEMP);
-        auto const& qar_rhoin = q.array(QRHO);
-        auto const& coe_rhoD = coeff_cc.array(dComp_rhoD);
-        auto const& coe_mu = coeff_cc.array(dComp_mu);
-        auto const& coe_xi = coeff_cc.array(dComp_xi);
-        auto const& coe_lambda = coeff_cc.array(dComp_lambda);
-        BL_PROFILE("PeleC::get_transport_coeffs()");
-        // Get Transport coefs on GPU.
-        amrex::launch(gbox, [=] AMREX_GPU_DEVICE(amrex::Box const& tbx) {
-          get_transport_coeffs(
-            tbx, qar_yin, qar_Tin, qar_rhoin, coe_rhoD, coe_mu, coe_xi,
-            coe_lambda);
-        });
+        if (nscbc_tile) {
+          amrex::GpuArray<amrex::Array4<int>, AMREX_SPACEDIM> bcMaskarr;
+          for (int dir = 0; dir < AMREX_SPACEDIM; dir++) {
+            bcMask[dir].resize(amrex::surroundingNodes(gbox, dir), 1);
+            bcMask_eli[dir] = bcMask[dir].elixir();
+            bcMask[dir].setVal<amrex::RunOn::Device>(0);
+            bcMaskarr[dir] = bcMask[dir].array();
+            bcm[dir] = bcMask[dir].const_array();
+          }
+          pc_impose_NSCBC(
+            gbox, qarr, qauxarr, bcMaskarr, phys_bc.lo(), phys_bc.hi(),
+            flag_nscbc_perio, geom, time);
+        }
+
+        // Compute transport coefficients, coincident with Q
+        {
+          auto const& qar_yin = q.array(QFS);
+          auto const& qar_Tin = q.array(QTEMP);
+          auto const& qar_rhoin = q.array(QRHO);
+          auto const& coe_rhoD = coeff_cc.array(dComp_rhoD);
+          auto const& coe_mu = coeff_cc.array(dComp_mu);
+          auto const& coe_xi = coeff_cc.array(dComp_xi);
+          auto const& coe_lambda = coeff_cc.array(dComp_lambda);
+          BL_PROFILE("PeleC::get_transport_coeffs()");
+          // Get Transport coefs on GPU.
+          amrex::launch(gbox, [=] AMREX_GPU_DEVICE(amrex::Box const& tbx) {
+            get_transport_coeffs(
+              tbx, qar_yin, qar_Tin, qar_rhoin, coe_rhoD, coe_mu, coe_xi,
+              coe_lambda);
+          });
+        }
+        qar = q.const_array();
+        qauxar = qaux.const_array();
+        coe_cc = coeff_cc.const_array();
       }
 
       amrex::FArrayBox flux_ec[AMREX_SPACEDIM];
@@ -374,7 +391,8 @@ PeleC::getMOLSrcTerm(
 #endif
           auto const& vol = volume.array(mfi);
           pc_compute_hyp_mol_flux(
-            cbox, qar, qauxar, flx, a, dx, plm_iorder
+            cbox, qar, qauxar, flx, a, dx, plm_iorder, mol_weno_order,
+            geom.Domain(), bcm
 #ifdef PELEC_USE_EB
             ,
             eb_small_vfrac, vfrac.array(mfi), flags.array(mfi),
@@ -520,14 +538,24 @@ PeleC::getMOLSrcTerm(
             dm_as_fine_eli = dm_as_fine.elixir();
             dm_as_fine.setVal<amrex::RunOn::Device>(0.0);
           }
-          BL_PROFILE("PeleC::pc_fix_div_and_redistribute()");
-          pc_fix_div_and_redistribute(
-            vbox, vol, dt, NVAR, eb_small_vfrac, levmsk_notcovered,
-            d_sv_eb_bndry_geom, Ncut, flags.array(mfi),
-            AMREX_D_DECL(flx[0], flx[1], flx[2]), sv_eb_flux[local_i].dataPtr(),
-            nFlux, vfrac.array(mfi), W, as_crse, as_fine, level_mask.array(mfi),
-            (*p_rrflag_as_crse).array(), Dterm, (*p_drho_as_crse).array(),
-            dm_as_fine.array());
+          if (state_redist) {
+            BL_PROFILE("PeleC::pc_state_redistribute()");
+            pc_state_redistribute(
+              vbox, vol, dt, NVAR, eb_srd_target_vfrac, d_sv_eb_bndry_geom,
+              Ncut, flags.array(mfi), AMREX_D_DECL(flx[0], flx[1], flx[2]),
+              sv_eb_flux[local_i].dataPtr(), vfrac.array(mfi),
+              S.const_array(mfi), Dterm, getEBRedistScratch(mfi, NVAR));
+          } else {
+            BL_PROFILE("PeleC::pc_fix_div_and_redistribute()");
+            pc_fix_div_and_redistribute(
+              vbox, vol, dt, NVAR, eb_small_vfrac, levmsk_notcovered,
+              d_sv_eb_bndry_geom, Ncut, flags.array(mfi),
+              AMREX_D_DECL(flx[0], flx[1], flx[2]),
+              sv_eb_flux[local_i].dataPtr(), nFlux, vfrac.array(mfi), W,
+              as_crse, as_fine, level_mask.array(mfi),
+              (*p_rrflag_as_crse).array(), Dterm, (*p_drho_as_crse).array(),
+              dm_as_fine.array(), getEBRedistScratch(mfi, NVAR));
+          }
         }
 
         if (do_reflux && flux_factor != 0) {
@@ -269,6 +269,50 @@ pc_apply_face_stencil(
   }
 }
 
+namespace {
+
+// Conservative divergence of the centroid fluxes on the cut cells of bx
+// grown by 2, all the components at once
+void
+pc_eb_cut_cell_div(
+  const amrex::Box bx,
+  const amrex::Real vol,
+  const int nc,
+  const EBBndryGeom* sv_ebg,
+  const int Ncut,
+  const amrex::Array4<const amrex::Real>& f0,
+  const amrex::Array4<const amrex::Real>& f1,
+  const amrex::Array4<const amrex::Real>& f2,
+  const amrex::Real* ebflux,
+  const amrex::Array4<const amrex::Real>& vf,
+  const amrex::Array4<amrex::Real>& DC)
+{
+  const auto lo = amrex::lbound(bx);
+  const auto hi = amrex::ubound(bx);
+  const amrex::Real volinv = 1.0 / vol;
+  amrex::ParallelFor(Ncut * nc, [=] AMREX_GPU_DEVICE(int m) {
+    const int L = m % Ncut;
+    const int n = m / Ncut;
+    const int i = sv_ebg[L].iv[0];
+    const int j = sv_ebg[L].iv[1];
+    const int k = sv_ebg[L].iv[2];
+    if (is_inside(i, j, k, lo, hi, 2)) {
+      const amrex::Real kappa_inv = 1.0 / amrex::max(vf(i, j, k), 1.0e-12);
+      amrex::Real tmp;
+#ifdef _OPENMP
+#pragma omp atomic read
+#endif
+      tmp = ebflux[m];
+      DC(i, j, k, n) =
+        -(f0(i + 1, j, k, n) - f0(i, j, k, n) + f1(i, j + 1, k, n) -
+          f1(i, j, k, n) + f2(i, j, k + 1, n) - f2(i, j, k, n) + tmp) *
+        volinv * kappa_inv;
+    }
+  });
+}
+
+} // namespace
+
 void
 pc_fix_div_and_redistribute(
   const amrex::Box bx,
@@ -293,194 +337,322 @@ pc_fix_div_and_redistribute(
   const amrex::Array4<const int>& rr_flag_crse,
   const amrex::Array4<amrex::Real>& DC,
   const amrex::Array4<amrex::Real>& rr_drho_crse,
-  const amrex::Array4<amrex::Real>& dm_as_fine)
+  const amrex::Array4<amrex::Real>& dm_as_fine,
+  amrex::Real* scratch)
 {
   const auto lo = amrex::lbound(bx);
   const auto hi = amrex::ubound(bx);
-  const amrex::Real volinv = 1.0 / vol;
-
-  for (int n = 0; n < nc; n++) {
-
-    // Recompute conservative divergence, DC, on cut cells...need DC in 2 grow
-    // cells for final result
-    amrex::ParallelFor(Ncut, [=] AMREX_GPU_DEVICE(int L) {
-      const int i = sv_ebg[L].iv[0];
-      const int j = sv_ebg[L].iv[1];
-      const int k = sv_ebg[L].iv[2];
-      if (is_inside(i, j, k, lo, hi, 2)) {
-        const amrex::Real kappa_inv = 1.0 / amrex::max(vf(i, j, k), 1.0e-12);
-        amrex::Real tmp;
-#ifdef _OPENMP
-#pragma omp atomic read
-#endif
-        tmp = ebflux[n * Ncut + L];
-        DC(i, j, k, n) =
-          -(f0(i + 1, j, k, n) - f0(i, j, k, n) + f1(i, j + 1, k, n) -
-            f1(i, j, k, n) + f2(i, j, k + 1, n) - f2(i, j, k, n) + tmp) *
-          volinv * kappa_inv;
+  const amrex::Real reredistribution_threshold =
+    amrex_eb_get_reredistribution_threshold();
+
+  // All the components go through each kernel at once, the cut cell index
+  // running fastest. dM and HD of component n on cut cell L are
+  // scratch[n * Ncut + L] and scratch[(nc + n) * Ncut + L], only read where
+  // they were written so the scratch needs no initialization
+  const int Ntot = Ncut * nc;
+  amrex::Real* dM = scratch;
+  amrex::Real* HD = scratch + Ntot;
+
+  // Recompute conservative divergence, DC, on cut cells...need DC in 2 grow
+  // cells for final result
+  pc_eb_cut_cell_div(bx, vol, nc, sv_ebg, Ncut, f0, f1, f2, ebflux, vf, DC);
+
+  // Compute non-conservative and hybrid divergence, DNC and HD, and
+  // redistribution mass dM in cut cells. Will need in 1 grow cells (see
+  // below), so it depends on having a conservative div in 2 grow cells
+  amrex::ParallelFor(Ntot, [=] AMREX_GPU_DEVICE(int m) {
+    const int L = m % Ncut;
+    const int n = m / Ncut;
+    const int i = sv_ebg[L].iv[0];
+    const int j = sv_ebg[L].iv[1];
+    const int k = sv_ebg[L].iv[2];
+    if (is_inside(i, j, k, lo, hi, 1)) {
+      amrex::Real sum_kappa = 0.0, sum_div = 0.0;
+      for (int ii = -1; ii <= 1; ii++) {
+        for (int jj = -1; jj <= 1; jj++) {
+          for (int kk = -1; kk <= 1; kk++) {
+            sum_kappa += flags(i, j, k).isConnected(ii, jj, kk) *
+                         vf(i + ii, j + jj, k + kk);
+            sum_div += flags(i, j, k).isConnected(ii, jj, kk) *
+                       vf(i + ii, j + jj, k + kk) *
+                       DC(i + ii, j + jj, k + kk, n);
+          }
+        }
       }
-    });
+      const amrex::Real DNC = sum_div / sum_kappa;
+      if (sv_ebg[L].eb_vfrac < eb_small_vfrac) {
+        dM[m] = vf(i, j, k) * DC(i, j, k, n);
+        HD[m] = 0.0;
+      } else {
+        dM[m] = vf(i, j, k) * (1.0 - vf(i, j, k)) * (DC(i, j, k, n) - DNC);
+        HD[m] = vf(i, j, k) * DC(i, j, k, n) + (1.0 - vf(i, j, k)) * DNC;
+      }
+    }
+  });
+
+  // Now that we finished computing HD and dM everywhere, it is safe to
+  // increment DC to hold HD
+  amrex::ParallelFor(Ntot, [=] AMREX_GPU_DEVICE(int m) {
+    const int L = m % Ncut;
+    const int n = m / Ncut;
+    const int i = sv_ebg[L].iv[0];
+    const int j = sv_ebg[L].iv[1];
+    const int k = sv_ebg[L].iv[2];
+    if (is_inside(i, j, k, lo, hi, 1)) {
+      DC(i, j, k, n) = HD[m];
+    }
+  });
 
-    // Compute non-conservative and hybrid divergence, DNC and HD, and
-    // redistribution mass dM in cut cells. Will need in 1 grow cells (see
-    // below), so it depends on having a conservative div in 2 grow cells
-    amrex::Vector<amrex::Real> dM_vec(Ncut, 0.0);
-    amrex::Vector<amrex::Real> HD_vec(Ncut, 0.0);
-    amrex::AsyncArray<amrex::Real> h_dM(dM_vec.data(), dM_vec.size());
-    amrex::AsyncArray<amrex::Real> h_HD(HD_vec.data(), HD_vec.size());
-    amrex::Real* dM = h_dM.data();
-    amrex::Real* HD = h_HD.data();
-    amrex::Gpu::synchronize();
-    amrex::ParallelFor(Ncut, [=] AMREX_GPU_DEVICE(int L) {
-      const int i = sv_ebg[L].iv[0];
-      const int j = sv_ebg[L].iv[1];
-      const int k = sv_ebg[L].iv[2];
-      if (is_inside(i, j, k, lo, hi, 1)) {
-        amrex::Real sum_kappa = 0.0, sum_div = 0.0;
-        for (int ii = -1; ii <= 1; ii++) {
-          for (int jj = -1; jj <= 1; jj++) {
-            for (int kk = -1; kk <= 1; kk++) {
-              sum_kappa += flags(i, j, k).isConnected(ii, jj, kk) *
-                           vf(i + ii, j + jj, k + kk);
-              sum_div += flags(i, j, k).isConnected(ii, jj, kk) *
-                         vf(i + ii, j + jj, k + kk) *
-                         DC(i + ii, j + jj, k + kk, n);
+  // Redistribute dM - THIS REQUIRES THAT DC BE GOOD IN 1 GROW CELL
+  amrex::ParallelFor(Ntot, [=] AMREX_GPU_DEVICE(int m) {
+    const int L = m % Ncut;
+    const int n = m / Ncut;
+    const int i = sv_ebg[L].iv[0];
+    const int j = sv_ebg[L].iv[1];
+    const int k = sv_ebg[L].iv[2];
+    if (is_inside(i, j, k, lo, hi, 1)) {
+      amrex::Real sum_kappa = 0.0;
+      for (int ii = -1; ii <= 1; ii++) {
+        for (int jj = -1; jj <= 1; jj++) {
+          for (int kk = -1; kk <= 1; kk++) {
+            int nbr = flags(i, j, k).isConnected(ii, jj, kk);
+            if ((ii == 0) and (jj == 0) and (kk == 0)) {
+              nbr = 0;
+            }
+            if (vf(i + ii, j + jj, k + kk) < eb_small_vfrac) {
+              nbr = 0;
             }
+            sum_kappa +=
+              nbr * vf(i + ii, j + jj, k + kk) * W(i + ii, j + jj, k + kk);
           }
         }
-        const amrex::Real DNC = sum_div / sum_kappa;
-        if (sv_ebg[L].eb_vfrac < eb_small_vfrac) {
-          dM[L] = vf(i, j, k) * DC(i, j, k, n);
-          HD[L] = 0.0;
-        } else {
-          dM[L] = vf(i, j, k) * (1.0 - vf(i, j, k)) * (DC(i, j, k, n) - DNC);
-          HD[L] = vf(i, j, k) * DC(i, j, k, n) + (1.0 - vf(i, j, k)) * DNC;
+      }
+      const amrex::Real sum_kappa_inv = 1.0 / sum_kappa;
+      for (int ii = -1; ii <= 1; ii++) {
+        for (int jj = -1; jj <= 1; jj++) {
+          for (int kk = -1; kk <= 1; kk++) {
+            int nbr = flags(i, j, k).isConnected(ii, jj, kk);
+            if ((ii == 0) and (jj == 0) and (kk == 0)) {
+              nbr = 0;
+            }
+            if (vf(i + ii, j + jj, k + kk) < eb_small_vfrac) {
+              nbr = 0;
+            }
+            amrex::Gpu::Atomic::Add(
+              &DC(i + ii, j + jj, k + kk, n),
+              dM[m] * nbr * W(i + ii, j + jj, k + kk) * sum_kappa_inv);
+          }
         }
       }
-    });
 
-    // Now that we finished computing HD and dM everywhere, it is safe to
-    // increment DC to hold HD
-    amrex::ParallelFor(Ncut, [=] AMREX_GPU_DEVICE(int L) {
-      const int i = sv_ebg[L].iv[0];
-      const int j = sv_ebg[L].iv[1];
-      const int k = sv_ebg[L].iv[2];
-      if (is_inside(i, j, k, lo, hi, 1)) {
-        DC(i, j, k, n) = HD[L];
+      // re redistribution book keeping
+      bool as_crse_crse_cell = false;
+      bool as_crse_covered_cell = false;
+      if (as_crse) {
+        as_crse_crse_cell =
+          is_inside(i, j, k, lo, hi) and
+          (rr_flag_crse(i, j, k) == amrex_yafluxreg_crse_fine_boundary_cell);
+        as_crse_covered_cell =
+          rr_flag_crse(i, j, k) == amrex_yafluxreg_fine_cell;
       }
-    });
 
-    // Redistribute dM - THIS REQUIRES THAT DC BE GOOD IN 1 GROW CELL
-    const amrex::Real reredistribution_threshold =
-      amrex_eb_get_reredistribution_threshold();
-    amrex::ParallelFor(Ncut, [=] AMREX_GPU_DEVICE(int L) {
-      const int i = sv_ebg[L].iv[0];
-      const int j = sv_ebg[L].iv[1];
-      const int k = sv_ebg[L].iv[2];
-      if (is_inside(i, j, k, lo, hi, 1)) {
-        amrex::Real sum_kappa = 0.0;
-        for (int ii = -1; ii <= 1; ii++) {
-          for (int jj = -1; jj <= 1; jj++) {
-            for (int kk = -1; kk <= 1; kk++) {
-              int nbr = flags(i, j, k).isConnected(ii, jj, kk);
-              if ((ii == 0) and (jj == 0) and (kk == 0)) {
-                nbr = 0;
+      bool as_fine_valid_cell = false; // valid cells near box boundary
+      bool as_fine_ghost_cell = false; // ghost cells just outside valid region
+      if (as_fine) {
+        as_fine_valid_cell = is_inside(i, j, k, lo, hi);
+        as_fine_ghost_cell =
+          (levmsk(i, j, k) == levmsk_notcovered); // not covered by other grids
+      }
+
+      for (int ii = -1; ii <= 1; ii++) {
+        for (int jj = -1; jj <= 1; jj++) {
+          for (int kk = -1; kk <= 1; kk++) {
+            if (
+              ((ii != 0) || (jj != 0) || (kk != 0)) and
+              flags(i, j, k).isConnected(ii, jj, kk)) {
+
+              const int iii = i + ii;
+              const int jjj = j + jj;
+              const int kkk = k + kk;
+
+              const amrex::Real drho = dM[m] * sum_kappa_inv * W(iii, jjj, kkk);
+              const bool valid_dst_cell = is_inside(iii, jjj, kkk, lo, hi);
+
+              if (
+                (as_crse_crse_cell) and
+                (rr_flag_crse(iii, jjj, kkk) == amrex_yafluxreg_fine_cell) and
+                (vf(i, j, k) > reredistribution_threshold)) {
+                // Also a neighbour of the other cut cells
+                amrex::Gpu::Atomic::Add(
+                  &rr_drho_crse(i, j, k, n),
+                  dt * drho * (vf(iii, jjj, kkk) / vf(i, j, k)));
               }
-              if (vf(i + ii, j + jj, k + kk) < eb_small_vfrac) {
-                nbr = 0;
+
+              // Neighbours are shared with the other cut cells
+              if (
+                (as_crse_covered_cell) and (valid_dst_cell) and
+                (rr_flag_crse(iii, jjj, kkk) ==
+                 amrex_yafluxreg_crse_fine_boundary_cell) and
+                (vf(iii, jjj, kkk) > reredistribution_threshold)) {
+                // the recipient is a crse/fine boundary cell
+                amrex::Gpu::Atomic::Add(
+                  &rr_drho_crse(iii, jjj, kkk, n), -dt * drho);
               }
-              sum_kappa +=
-                nbr * vf(i + ii, j + jj, k + kk) * W(i + ii, j + jj, k + kk);
-            }
-          }
-        }
-        const amrex::Real sum_kappa_inv = 1.0 / sum_kappa;
-        for (int ii = -1; ii <= 1; ii++) {
-          for (int jj = -1; jj <= 1; jj++) {
-            for (int kk = -1; kk <= 1; kk++) {
-              int nbr = flags(i, j, k).isConnected(ii, jj, kk);
-              if ((ii == 0) and (jj == 0) and (kk == 0)) {
-                nbr = 0;
+
+              if ((as_fine_valid_cell) and (!valid_dst_cell)) {
+                amrex::Gpu::Atomic::Add(
+                  &dm_as_fine(iii, jjj, kkk, n),
+                  dt * drho * vf(iii, jjj, kkk));
               }
-              if (vf(i + ii, j + jj, k + kk) < eb_small_vfrac) {
-                nbr = 0;
+
+              if ((as_fine_ghost_cell) and (valid_dst_cell)) {
+                amrex::Gpu::Atomic::Add(
+                  &dm_as_fine(i, j, k, n), -dt * drho * vf(iii, jjj, kkk));
               }
-              amrex::Gpu::Atomic::Add(
-                &DC(i + ii, j + jj, k + kk, n),
-                dM[L] * nbr * W(i + ii, j + jj, k + kk) * sum_kappa_inv);
-              // DC(i + ii, j + jj, k + kk, n) += dM[L] * nbr * W(i + ii, j +
-              // jj, k + kk) * sum_kappa_inv;
             }
           }
         }
+      }
+    }
+  });
+}
 
-        // re redistribution book keeping
-        bool as_crse_crse_cell = false;
-        bool as_crse_covered_cell = false;
-        if (as_crse) {
-          as_crse_crse_cell =
-            is_inside(i, j, k, lo, hi) and
-            (rr_flag_crse(i, j, k) == amrex_yafluxreg_crse_fine_boundary_cell);
-          as_crse_covered_cell =
-            rr_flag_crse(i, j, k) == amrex_yafluxreg_fine_cell;
+void
+pc_state_redistribute(
+  const amrex::Box bx,
+  const amrex::Real vol,
+  const amrex::Real dt,
+  const int nc,
+  const amrex::Real target_vfrac,
+  const EBBndryGeom* sv_ebg,
+  const int Ncut,
+  const amrex::Array4<amrex::EBCellFlag const>& flags,
+  const amrex::Array4<const amrex::Real>& f0,
+  const amrex::Array4<const amrex::Real>& f1,
+  const amrex::Array4<const amrex::Real>& f2,
+  const amrex::Real* ebflux,
+  const amrex::Array4<const amrex::Real>& vf,
+  const amrex::Array4<const amrex::Real>& U,
+  const amrex::Array4<amrex::Real>& DC,
+  amrex::Real* scratch)
+{
+  const auto lo = amrex::lbound(bx);
+  const auto hi = amrex::ubound(bx);
+
+  // The cells with a volume fraction below target_vfrac are merged with
+  // their neighbourhoods (pc_srd_neighborhood), the other cells are their
+  // own neighbourhood. Each cell j, in N_j neighbourhoods, puts V_j / N_j of
+  // its volume in each of them. The provisional state Uh = U + dt DC is
+  // averaged on each neighbourhood and the new state of a cell is the mean
+  // of the averages of its neighbourhoods. DC is then (U_new - U) / dt on bx,
+  // which needs the conservative divergence in 2 grow cells
+  pc_eb_cut_cell_div(bx, vol, nc, sv_ebg, Ncut, f0, f1, f2, ebflux, vf, DC);
+
+  // Number of neighbourhoods of the cells in 2 grow cells, which the
+  // neighbourhoods of the cut cells in 3 grow cells reach
+  const amrex::Box nbx = amrex::grow(bx, 2);
+  amrex::FArrayBox nrs_fab(nbx, 1);
+  amrex::Elixir nrs_eli = nrs_fab.elixir();
+  auto const& nrs = nrs_fab.array();
+  nrs_fab.setVal<amrex::RunOn::Device>(1.0);
+  amrex::ParallelFor(Ncut, [=] AMREX_GPU_DEVICE(int L) {
+    const int i = sv_ebg[L].iv[0];
+    const int j = sv_ebg[L].iv[1];
+    const int k = sv_ebg[L].iv[2];
+    if (is_inside(i, j, k, lo, hi, 3)) {
+      const int nbhd =
+        pc_srd_neighborhood(i, j, k, sv_ebg[L], flags, vf, target_vfrac);
+      for (int b = 0; b < 27; b++) {
+        const int ii = i + b % 3 - 1;
+        const int jj = j + (b / 3) % 3 - 1;
+        const int kk = k + b / 9 - 1;
+        if (((nbhd >> b) & 1) and is_inside(ii, jj, kk, lo, hi, 2)) {
+          amrex::Gpu::Atomic::Add(&nrs(ii, jj, kk), 1.0);
         }
+      }
+    }
+  });
 
-        bool as_fine_valid_cell = false; // valid cells near box boundary
-        bool as_fine_ghost_cell =
-          false; // ghost cells just outside valid region
-        if (as_fine) {
-          as_fine_valid_cell = is_inside(i, j, k, lo, hi);
-          as_fine_ghost_cell =
-            (levmsk(i, j, k) ==
-             levmsk_notcovered); // not covered by other grids
+  // Volumes of the neighbourhoods of the merged cells in 1 grow cell
+  amrex::Real* Vh = scratch;
+  amrex::ParallelFor(Ncut, [=] AMREX_GPU_DEVICE(int L) {
+    const int i = sv_ebg[L].iv[0];
+    const int j = sv_ebg[L].iv[1];
+    const int k = sv_ebg[L].iv[2];
+    if (is_inside(i, j, k, lo, hi, 1)) {
+      const int nbhd =
+        pc_srd_neighborhood(i, j, k, sv_ebg[L], flags, vf, target_vfrac);
+      amrex::Real vh = vf(i, j, k) / nrs(i, j, k);
+      for (int b = 0; b < 27; b++) {
+        if ((nbhd >> b) & 1) {
+          const int ii = i + b % 3 - 1;
+          const int jj = j + (b / 3) % 3 - 1;
+          const int kk = k + b / 9 - 1;
+          vh += vf(ii, jj, kk) / nrs(ii, jj, kk);
         }
+      }
+      Vh[L] = vh;
+    }
+  });
 
-        for (int ii = -1; ii <= 1; ii++) {
-          for (int jj = -1; jj <= 1; jj++) {
-            for (int kk = -1; kk <= 1; kk++) {
-              if (
-                ((ii != 0) || (jj != 0) || (kk != 0)) and
-                flags(i, j, k).isConnected(ii, jj, kk)) {
-
-                const int iii = i + ii;
-                const int jjj = j + jj;
-                const int kkk = k + kk;
-
-                const amrex::Real drho =
-                  dM[L] * sum_kappa_inv * W(iii, jjj, kkk);
-                const bool valid_dst_cell = is_inside(iii, jjj, kkk, lo, hi);
-
-                if (
-                  (as_crse_crse_cell) and
-                  (rr_flag_crse(iii, jjj, kkk) == amrex_yafluxreg_fine_cell) and
-                  (vf(i, j, k) > reredistribution_threshold)) {
-                  rr_drho_crse(i, j, k, n) +=
-                    dt * drho * (vf(iii, jjj, kkk) / vf(i, j, k));
-                }
-
-                if (
-                  (as_crse_covered_cell) and (valid_dst_cell) and
-                  (rr_flag_crse(iii, jjj, kkk) ==
-                   amrex_yafluxreg_crse_fine_boundary_cell) and
-                  (vf(iii, jjj, kkk) > reredistribution_threshold)) {
-                  // the recipient is a crse/fine boundary cell
-                  rr_drho_crse(iii, jjj, kkk, n) -= dt * drho;
-                }
-
-                if ((as_fine_valid_cell) and (!valid_dst_cell)) {
-                  dm_as_fine(iii, jjj, kkk, n) += dt * drho * vf(iii, jjj, kkk);
-                }
-
-                if ((as_fine_ghost_cell) and (valid_dst_cell)) {
-                  dm_as_fine(i, j, k, n) -= dt * drho * vf(iii, jjj, kkk);
-                }
-              }
-            }
-          }
+  // Contributions of the neighbourhoods to the new state of the cells of bx,
+  // beyond Uh for the cells that are their own neighbourhood
+  amrex::FArrayBox acc_fab(bx, nc);
+  amrex::Elixir acc_eli = acc_fab.elixir();
+  auto const& acc = acc_fab.array();
+  acc_fab.setVal<amrex::RunOn::Device>(0.0);
+  amrex::ParallelFor(Ncut * nc, [=] AMREX_GPU_DEVICE(int m) {
+    const int L = m % Ncut;
+    const int n = m / Ncut;
+    const int i = sv_ebg[L].iv[0];
+    const int j = sv_ebg[L].iv[1];
+    const int k = sv_ebg[L].iv[2];
+    if (is_inside(i, j, k, lo, hi, 1)) {
+      const int nbhd =
+        pc_srd_neighborhood(i, j, k, sv_ebg[L], flags, vf, target_vfrac);
+      if (nbhd == 0) {
+        return;
+      }
+      const amrex::Real Uh = U(i, j, k, n) + dt * DC(i, j, k, n);
+      amrex::Real q = vf(i, j, k) / nrs(i, j, k) * Uh;
+      for (int b = 0; b < 27; b++) {
+        if ((nbhd >> b) & 1) {
+          const int ii = i + b % 3 - 1;
+          const int jj = j + (b / 3) % 3 - 1;
+          const int kk = k + b / 9 - 1;
+          q += vf(ii, jj, kk) / nrs(ii, jj, kk) *
+               (U(ii, jj, kk, n) + dt * DC(ii, jj, kk, n));
+        }
+      }
+      q /= Vh[L];
+
+      if (is_inside(i, j, k, lo, hi)) {
+        amrex::Gpu::Atomic::Add(&acc(i, j, k, n), q - Uh);
+      }
+      for (int b = 0; b < 27; b++) {
+        const int ii = i + b % 3 - 1;
+        const int jj = j + (b / 3) % 3 - 1;
+        const int kk = k + b / 9 - 1;
+        if (((nbhd >> b) & 1) and is_inside(ii, jj, kk, lo, hi)) {
+          amrex::Gpu::Atomic::Add(&acc(ii, jj, kk, n), q);
         }
       }
+    }
+  });
+
+  // New state and update of the cells that were merged
+  amrex::ParallelFor(
+    bx, nc, [=] AMREX_GPU_DEVICE(int i, int j, int k, int n) noexcept {
+      const bool merged =
+        (nrs(i, j, k) > 1.0) or
+        (flags(i, j, k).isSingleValued() and (vf(i, j, k) < target_vfrac));
+      if (merged) {
+        const amrex::Real Unew =
+          (U(i, j, k, n) + dt * DC(i, j, k, n) + acc(i, j, k, n)) /
+          nrs(i, j, k);
+        DC(i, j, k, n) = (Unew - U(i, j, k, n)) / dt;
+      }
     });
-  }
 }
 
 void
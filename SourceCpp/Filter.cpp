@@ -420,6 +420,18 @@ Filter::set_gaussian_5pt_optimized_approx_weights()
   _weights[4] = _weights[0];
 }
 
+/**
+ * Keep a copy of the weights in device memory for the life of the filter
+ **/
+void
+Filter::set_device_weights()
+{
+  _dweights.resize(_nweights);
+  amrex::Gpu::copy(
+    amrex::Gpu::hostToDevice, _weights.begin(), _weights.end(),
+    _dweights.begin());
+}
+
 /**
  * Run the filtering operation on a MultiFab
  **/
@@ -485,25 +497,175 @@ Filter::apply_filter(
   const int ncomp)
 {
 
-  const auto q = in.array();
-  auto qh = out.array();
-  setC(box, nstart, ncnt, qh, 0.0);
-  const amrex::AsyncArray<amrex::Real> weights(
-    _weights.data(), _weights.size());
-  const amrex::Real* w = weights.data();
+  // The weights are a tensor product of the 1D weights, so the filter is
+  // applied one direction at a time. Each pass but the last one writes
+  // into a staged buffer that is still grown in the directions left to
+  // filter. This is O(3n) work per point instead of O(n^3).
+  const int nc = ncnt - nstart;
+  const amrex::Real* w = _dweights.data();
+  const int captured_ngrow = _ngrow;
+
+  amrex::FArrayBox stage[AMREX_SPACEDIM];
+  amrex::Elixir stage_eli[AMREX_SPACEDIM];
+  amrex::Array4<const amrex::Real> src = in.const_array();
+  for (int dir = 0; dir < AMREX_SPACEDIM; dir++) {
+    amrex::Box dbox(box);
+    for (int d = dir + 1; d < AMREX_SPACEDIM; d++) {
+      dbox.grow(d, _ngrow);
+    }
+
+    amrex::Array4<amrex::Real> dst;
+    int dst_comp = 0;
+    if (dir == AMREX_SPACEDIM - 1) {
+      dst = out.array();
+      dst_comp = nstart;
+    } else {
+      stage[dir].resize(dbox, nc);
+      stage_eli[dir] = stage[dir].elixir();
+      dst = stage[dir].array();
+    }
+
+    const int di = (dir == 0) ? 1 : 0;
+    const int dj = (dir == 1) ? 1 : 0;
+    const int dk = (dir == 2) ? 1 : 0;
+    amrex::ParallelFor(
+      dbox, nc, [=] AMREX_GPU_DEVICE(int i, int j, int k, int n) noexcept {
+        amrex::Real sum = 0.0;
+        for (int l = -captured_ngrow; l <= captured_ngrow; l++) {
+          sum +=
+            w[l + captured_ngrow] * src(i + l * di, j + l * dj, k + l * dk, n);
+        }
+        dst(i, j, k, n + dst_comp) = sum;
+      });
 
+    if (dir < AMREX_SPACEDIM - 1) {
+      src = stage[dir].const_array();
+    }
+  }
+}
+
+void
+Filter::apply_filter(
+  const amrex::Box& box,
+  const amrex::Vector<const amrex::FArrayBox*>& in,
+  const amrex::Vector<amrex::FArrayBox*>& out)
+{
+  BL_PROFILE("Filter::apply_filter()");
+  const int nf = static_cast<int>(in.size());
+  AMREX_ALWAYS_ASSERT(static_cast<int>(out.size()) == nf && nf <= max_fields);
+
+  // Components of all the fields are numbered one after the other, field f
+  // holding the ones in [off[f], off[f + 1])
+  amrex::GpuArray<amrex::Array4<const amrex::Real>, max_fields> fin;
+  amrex::GpuArray<amrex::Array4<amrex::Real>, max_fields> fout;
+  amrex::GpuArray<int, max_fields + 1> off;
+  off[0] = 0;
+  for (int f = 0; f < nf; f++) {
+    AMREX_ASSERT(in[f]->nComp() == out[f]->nComp());
+    fin[f] = in[f]->const_array();
+    fout[f] = out[f]->array();
+    off[f + 1] = off[f] + out[f]->nComp();
+  }
+  const int ntot = off[nf];
+  const amrex::Real* w = _dweights.data();
   const int captured_ngrow = _ngrow;
-  amrex::ParallelFor(
-    box, ncnt - nstart,
-    [=] AMREX_GPU_DEVICE(int i, int j, int k, int nc) noexcept {
-      for (int n = -captured_ngrow; n <= captured_ngrow; n++) {
-        for (int m = -captured_ngrow; m <= captured_ngrow; m++) {
-          for (int l = -captured_ngrow; l <= captured_ngrow; l++) {
-            qh(i, j, k, nc + nstart) +=
-              w[l + captured_ngrow] * w[m + captured_ngrow] *
-              w[n + captured_ngrow] * q(i + l, j + m, k + n, nc);
-          }
+
+  // Same staging as the single FAB version, with all the fields sharing the
+  // staged buffers
+  amrex::FArrayBox stage[AMREX_SPACEDIM];
+  amrex::Elixir stage_eli[AMREX_SPACEDIM];
+  for (int dir = 0; dir < AMREX_SPACEDIM; dir++) {
+    amrex::Box dbox(box);
+    for (int d = dir + 1; d < AMREX_SPACEDIM; d++) {
+      dbox.grow(d, _ngrow);
+    }
+
+    const bool first = (dir == 0);
+    const bool last = (dir == AMREX_SPACEDIM - 1);
+    amrex::Array4<const amrex::Real> src;
+    amrex::Array4<amrex::Real> dst;
+    if (!first) {
+      src = stage[dir - 1].const_array();
+    }
+    if (!last) {
+      stage[dir].resize(dbox, ntot);
+      stage_eli[dir] = stage[dir].elixir();
+      dst = stage[dir].array();
+    }
+
+    const int di = (dir == 0) ? 1 : 0;
+    const int dj = (dir == 1) ? 1 : 0;
+    const int dk = (dir == 2) ? 1 : 0;
+    amrex::ParallelFor(
+      dbox, ntot, [=] AMREX_GPU_DEVICE(int i, int j, int k, int n) noexcept {
+        int f = 0;
+        while (n >= off[f + 1]) {
+          f++;
         }
-      }
-    });
+        const int c = n - off[f];
+        amrex::Real sum = 0.0;
+        for (int l = -captured_ngrow; l <= captured_ngrow; l++) {
+          const int ii = i + l * di;
+          const int jj = j + l * dj;
+          const int kk = k + l * dk;
+          sum += w[l + captured_ngrow] *
+                 (first ? fin[f](ii, jj, kk, c) : src(ii, jj, kk, n));
+        }
+        if (last) {
+          fout[f](i, j, k, c) = sum;
+        } else {
+          dst(i, j, k, n) = sum;
+        }
+      });
+  }
+}
+
+void
+Filter::apply_weighted_filter(
+  const amrex::Box& box,
+  const amrex::Vector<const amrex::FArrayBox*>& in,
+  const amrex::Vector<amrex::FArrayBox*>& out,
+  const amrex::FArrayBox& w)
+{
+  BL_PROFILE("Filter::apply_weighted_filter()");
+  const int nf = static_cast<int>(in.size());
+  AMREX_ALWAYS_ASSERT(static_cast<int>(out.size()) == nf && nf < max_fields);
+
+  // Weighted copies of the inputs, filtered along with the weight itself
+  const amrex::Box gbox = amrex::grow(box, _ngrow);
+  AMREX_ASSERT(w.box().contains(gbox));
+  auto const& wa = w.const_array();
+  amrex::Vector<amrex::FArrayBox> win(nf);
+  amrex::Vector<amrex::Elixir> win_eli(nf);
+  amrex::Vector<const amrex::FArrayBox*> fin(nf + 1);
+  amrex::Vector<amrex::FArrayBox*> fout(nf + 1);
+  for (int f = 0; f < nf; f++) {
+    const int ncomp = in[f]->nComp();
+    win[f].resize(gbox, ncomp);
+    win_eli[f] = win[f].elixir();
+    auto const& src = in[f]->const_array();
+    auto const& dst = win[f].array();
+    amrex::ParallelFor(
+      gbox, ncomp, [=] AMREX_GPU_DEVICE(int i, int j, int k, int n) noexcept {
+        dst(i, j, k, n) = wa(i, j, k) * src(i, j, k, n);
+      });
+    fin[f] = &win[f];
+    fout[f] = out[f];
+  }
+  amrex::FArrayBox wout(box, 1);
+  amrex::Elixir wout_eli = wout.elixir();
+  fin[nf] = &w;
+  fout[nf] = &wout;
+  apply_filter(box, fin, fout);
+
+  auto const& wf = wout.const_array();
+  for (int f = 0; f < nf; f++) {
+    auto const& o = out[f]->array();
+    amrex::ParallelFor(
+      box, out[f]->nComp(),
+      [=] AMREX_GPU_DEVICE(int i, int j, int k, int n) noexcept {
+        o(i, j, k, n) =
+          (wf(i, j, k) > 1.0e-12) ? o(i, j, k, n) / wf(i, j, k) : 0.0;
+      });
+  }
 }
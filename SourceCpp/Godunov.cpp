@@ -12,8 +12,8 @@ pc_umeth_3D(
   const int* domhi,
   amrex::Array4<const amrex::Real> const& q,
   amrex::Array4<const amrex::Real> const& qaux,
-  amrex::Array4<const amrex::Real> const&
-    srcQ, // amrex::IArrayBox const& bcMask,
+  amrex::Array4<const amrex::Real> const& srcQ,
+  const amrex::GpuArray<amrex::Array4<const int>, AMREX_SPACEDIM>& bcMask,
   amrex::Array4<amrex::Real> const& flx1,
   amrex::Array4<amrex::Real> const& flx2,
   amrex::Array4<amrex::Real> const&
@@ -29,7 +29,8 @@ pc_umeth_3D(
   const amrex::Real* del,
   const amrex::Real dt,
   const int ppm_type,
-  const int use_flattening)
+  const int use_flattening,
+  ScratchArena& scratch)
 {
   amrex::Real const dx = del[0];
   amrex::Real const dy = del[1];
@@ -55,15 +56,17 @@ pc_umeth_3D(
   const int dhy = domhi[1];
   const int dhz = domhi[2];
 
-  // auto const& bcMaskarr = bcMask.array();
+  auto const& bcmx = bcMask[0];
+  auto const& bcmy = bcMask[1];
+  auto const& bcmz = bcMask[2];
   const amrex::Box& bxg1 = grow(bx, 1);
   const amrex::Box& bxg2 = grow(bx, 2);
 
   // X data
   int cdir = 0;
   const amrex::Box& xmbx = growHi(bxg2, cdir, 1);
-  amrex::FArrayBox qxm(xmbx, QVAR);
-  amrex::FArrayBox qxp(bxg2, QVAR);
+  amrex::FArrayBox qxm = scratch.make_fab(xmbx, QVAR);
+  amrex::FArrayBox qxp = scratch.make_fab(bxg2, QVAR);
   amrex::Elixir qxmeli = qxm.elixir();
   amrex::Elixir qxpeli = qxp.elixir();
   auto const& qxmarr = qxm.array();
@@ -73,8 +76,8 @@ pc_umeth_3D(
   cdir = 1;
   const amrex::Box& yflxbx = surroundingNodes(grow(bxg2, cdir, -1), cdir);
   const amrex::Box& ymbx = growHi(bxg2, cdir, 1);
-  amrex::FArrayBox qym(ymbx, QVAR);
-  amrex::FArrayBox qyp(bxg2, QVAR);
+  amrex::FArrayBox qym = scratch.make_fab(ymbx, QVAR);
+  amrex::FArrayBox qyp = scratch.make_fab(bxg2, QVAR);
   amrex::Elixir qymeli = qym.elixir();
   amrex::Elixir qypeli = qyp.elixir();
   auto const& qymarr = qym.array();
@@ -84,8 +87,8 @@ pc_umeth_3D(
   cdir = 2;
   const amrex::Box& zmbx = growHi(bxg2, cdir, 1);
   const amrex::Box& zflxbx = surroundingNodes(grow(bxg2, cdir, -1), cdir);
-  amrex::FArrayBox qzm(zmbx, QVAR);
-  amrex::FArrayBox qzp(bxg2, QVAR);
+  amrex::FArrayBox qzm = scratch.make_fab(zmbx, QVAR);
+  amrex::FArrayBox qzp = scratch.make_fab(bxg2, QVAR);
   amrex::Elixir qzmeli = qzm.elixir();
   amrex::Elixir qzpeli = qzp.elixir();
   auto const& qzmarr = qzm.array();
@@ -136,63 +139,63 @@ pc_umeth_3D(
   // method X initial fluxes
   cdir = 0;
   const amrex::Box& xflxbx = surroundingNodes(grow(bxg2, cdir, -1), cdir);
-  amrex::FArrayBox fx(xflxbx, NVAR);
+  amrex::FArrayBox fx = scratch.make_fab(xflxbx, NVAR);
   amrex::Elixir fxeli = fx.elixir();
   auto const& fxarr = fx.array();
-  amrex::FArrayBox qgdx(xflxbx, NGDNV);
+  amrex::FArrayBox qgdx = scratch.make_fab(xflxbx, NGDNV);
   amrex::Elixir qgdxeli = qgdx.elixir();
   auto const& gdtempx = qgdx.array();
   amrex::ParallelFor(
     xflxbx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
       pc_cmpflx(
         i, j, k, bclx, bchx, dlx, dhx, qxmarr, qxparr, fxarr, gdtempx, qaux,
-        cdir);
+        bcmx, cdir);
     });
 
   // Y initial fluxes
   cdir = 1;
-  amrex::FArrayBox fy(yflxbx, NVAR);
+  amrex::FArrayBox fy = scratch.make_fab(yflxbx, NVAR);
   amrex::Elixir fyeli = fy.elixir();
   auto const& fyarr = fy.array();
-  amrex::FArrayBox qgdy(yflxbx, NGDNV);
+  amrex::FArrayBox qgdy = scratch.make_fab(yflxbx, NGDNV);
   amrex::Elixir qgdyeli = qgdy.elixir();
   auto const& gdtempy = qgdy.array();
   amrex::ParallelFor(
     yflxbx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
       pc_cmpflx(
         i, j, k, bcly, bchy, dly, dhy, qymarr, qyparr, fyarr, gdtempy, qaux,
-        cdir);
+        bcmy, cdir);
     });
 
   // Z initial fluxes
   cdir = 2;
-  amrex::FArrayBox fz(zflxbx, NVAR);
+  amrex::FArrayBox fz = scratch.make_fab(zflxbx, NVAR);
   amrex::Elixir fzeli = fz.elixir();
   auto const& fzarr = fz.array();
-  amrex::FArrayBox qgdz(zflxbx, NGDNV);
+  amrex::FArrayBox qgdz = scratch.make_fab(zflxbx, NGDNV);
   amrex::Elixir qgdzeli = qgdz.elixir();
   auto const& gdtempz = qgdz.array();
   amrex::ParallelFor(
     zflxbx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
       pc_cmpflx(
         i, j, k, bclz, bchz, dlz, dhz, qzmarr, qzparr, fzarr, gdtempz, qaux,
-        cdir);
+        bcmz, cdir);
     });
 
   // X interface corrections
   cdir = 0;
   const amrex::Box& txbx = grow(bxg1, cdir, 1);
   const amrex::Box& txbxm = growHi(txbx, cdir, 1);
-  amrex::FArrayBox qxym(txbxm, QVAR);
+  amrex::FArrayBox qxym = scratch.make_fab(txbxm, QVAR);
   amrex::Elixir qxymeli = qxym.elixir();
-  amrex::FArrayBox qxyp(txbx, QVAR);
+  amrex::FArrayBox qxyp = scratch.make_fab(txbx, QVAR);
   amrex::Elixir qxypeli = qxyp.elixir();
   auto const& qmxy = qxym.array();
   auto const& qpxy = qxyp.array();
 
-  amrex::FArrayBox qxzm(txbxm, QVAR);
+  amrex::FArrayBox qxzm = scratch.make_fab(txbxm, QVAR);
   amrex::Elixir qxzmeli = qxzm.elixir();
-  amrex::FArrayBox qxzp(txbx, QVAR);
+  amrex::FArrayBox qxzp = scratch.make_fab(txbx, QVAR);
   amrex::Elixir qxzpeli = qxzp.elixir();
   auto const& qmxz = qxzm.array();
   auto const& qpxz = qxzp.array();
@@ -207,10 +210,10 @@ pc_umeth_3D(
   });
 
   const amrex::Box& txfxbx = surroundingNodes(bxg1, cdir);
-  amrex::FArrayBox fluxxy(txfxbx, NVAR);
-  amrex::FArrayBox fluxxz(txfxbx, NVAR);
-  amrex::FArrayBox gdvxyfab(txfxbx, NGDNV);
-  amrex::FArrayBox gdvxzfab(txfxbx, NGDNV);
+  amrex::FArrayBox fluxxy = scratch.make_fab(txfxbx, NVAR);
+  amrex::FArrayBox fluxxz = scratch.make_fab(txfxbx, NVAR);
+  amrex::FArrayBox gdvxyfab = scratch.make_fab(txfxbx, NGDNV);
+  amrex::FArrayBox gdvxzfab = scratch.make_fab(txfxbx, NGDNV);
   amrex::Elixir fluxxyeli = fluxxy.elixir(), gdvxyeli = gdvxyfab.elixir();
   amrex::Elixir fluxxzeli = fluxxz.elixir(), gdvxzeli = gdvxzfab.elixir();
 
@@ -224,10 +227,10 @@ pc_umeth_3D(
     txfxbx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
       // X|Y
       pc_cmpflx(
-        i, j, k, bclx, bchx, dlx, dhx, qmxy, qpxy, flxy, qxy, qaux, cdir);
+        i, j, k, bclx, bchx, dlx, dhx, qmxy, qpxy, flxy, qxy, qaux, bcmx, cdir);
       // X|Z
       pc_cmpflx(
-        i, j, k, bclx, bchx, dlx, dhx, qmxz, qpxz, flxz, qxz, qaux, cdir);
+        i, j, k, bclx, bchx, dlx, dhx, qmxz, qpxz, flxz, qxz, qaux, bcmx, cdir);
     });
 
   qxymeli.clear();
@@ -239,10 +242,10 @@ pc_umeth_3D(
   cdir = 1;
   const amrex::Box& tybx = grow(bxg1, cdir, 1);
   const amrex::Box& tybxm = growHi(tybx, cdir, 1);
-  amrex::FArrayBox qyxm(tybxm, QVAR);
-  amrex::FArrayBox qyxp(tybx, QVAR);
-  amrex::FArrayBox qyzm(tybxm, QVAR);
-  amrex::FArrayBox qyzp(tybx, QVAR);
+  amrex::FArrayBox qyxm = scratch.make_fab(tybxm, QVAR);
+  amrex::FArrayBox qyxp = scratch.make_fab(tybx, QVAR);
+  amrex::FArrayBox qyzm = scratch.make_fab(tybxm, QVAR);
+  amrex::FArrayBox qyzp = scratch.make_fab(tybx, QVAR);
   amrex::Elixir qyxmeli = qyxm.elixir(), qyxpeli = qyxp.elixir();
   amrex::Elixir qyzmeli = qyzm.elixir(), qyzpeli = qyzp.elixir();
   auto const& qmyx = qyxm.array();
@@ -264,10 +267,10 @@ pc_umeth_3D(
 
   // Riemann problem Y|X Y|Z
   const amrex::Box& tyfxbx = surroundingNodes(bxg1, cdir);
-  amrex::FArrayBox fluxyx(tyfxbx, NVAR);
-  amrex::FArrayBox fluxyz(tyfxbx, NVAR);
-  amrex::FArrayBox gdvyxfab(tyfxbx, NGDNV);
-  amrex::FArrayBox gdvyzfab(tyfxbx, NGDNV);
+  amrex::FArrayBox fluxyx = scratch.make_fab(tyfxbx, NVAR);
+  amrex::FArrayBox fluxyz = scratch.make_fab(tyfxbx, NVAR);
+  amrex::FArrayBox gdvyxfab = scratch.make_fab(tyfxbx, NGDNV);
+  amrex::FArrayBox gdvyzfab = scratch.make_fab(tyfxbx, NGDNV);
   amrex::Elixir fluxyxeli = fluxyx.elixir(), gdvyxeli = gdvyxfab.elixir();
   amrex::Elixir fluxyzeli = fluxyz.elixir(), gdvyzeli = gdvyzfab.elixir();
 
@@ -280,10 +283,10 @@ pc_umeth_3D(
     tyfxbx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
       // Y|X
       pc_cmpflx(
-        i, j, k, bcly, bchy, dly, dhy, qmyx, qpyx, flyx, qyx, qaux, cdir);
+        i, j, k, bcly, bchy, dly, dhy, qmyx, qpyx, flyx, qyx, qaux, bcmy, cdir);
       // Y|Z
       pc_cmpflx(
-        i, j, k, bcly, bchy, dly, dhy, qmyz, qpyz, flyz, qyz, qaux, cdir);
+        i, j, k, bcly, bchy, dly, dhy, qmyz, qpyz, flyz, qyz, qaux, bcmy, cdir);
     });
 
   qyxmeli.clear();
@@ -295,10 +298,10 @@ pc_umeth_3D(
   cdir = 2;
   const amrex::Box& tzbx = grow(bxg1, cdir, 1);
   const amrex::Box& tzbxm = growHi(tzbx, cdir, 1);
-  amrex::FArrayBox qzxm(tzbxm, QVAR);
-  amrex::FArrayBox qzxp(tzbx, QVAR);
-  amrex::FArrayBox qzym(tzbxm, QVAR);
-  amrex::FArrayBox qzyp(tzbx, QVAR);
+  amrex::FArrayBox qzxm = scratch.make_fab(tzbxm, QVAR);
+  amrex::FArrayBox qzxp = scratch.make_fab(tzbx, QVAR);
+  amrex::FArrayBox qzym = scratch.make_fab(tzbxm, QVAR);
+  amrex::FArrayBox qzyp = scratch.make_fab(tzbx, QVAR);
   amrex::Elixir qzxmeli = qzxm.elixir(), qzxpeli = qzxp.elixir();
   amrex::Elixir qzymeli = qzym.elixir(), qzypeli = qzyp.elixir();
 
@@ -323,10 +326,10 @@ pc_umeth_3D(
 
   // Riemann problem Z|X Z|Y
   const amrex::Box& tzfxbx = surroundingNodes(bxg1, cdir);
-  amrex::FArrayBox fluxzx(tzfxbx, NVAR);
-  amrex::FArrayBox fluxzy(tzfxbx, NVAR);
-  amrex::FArrayBox gdvzxfab(tzfxbx, NGDNV);
-  amrex::FArrayBox gdvzyfab(tzfxbx, NGDNV);
+  amrex::FArrayBox fluxzx = scratch.make_fab(tzfxbx, NVAR);
+  amrex::FArrayBox fluxzy = scratch.make_fab(tzfxbx, NVAR);
+  amrex::FArrayBox gdvzxfab = scratch.make_fab(tzfxbx, NGDNV);
+  amrex::FArrayBox gdvzyfab = scratch.make_fab(tzfxbx, NGDNV);
   amrex::Elixir fluxzxeli = fluxzx.elixir(), gdvzxeli = gdvzxfab.elixir();
   amrex::Elixir fluxzyeli = fluxzy.elixir(), gdvzyeli = gdvzyfab.elixir();
 
@@ -339,10 +342,10 @@ pc_umeth_3D(
     tzfxbx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
       // Z|X
       pc_cmpflx(
-        i, j, k, bclz, bchz, dlz, dhz, qmzx, qpzx, flzx, qzx, qaux, cdir);
+        i, j, k, bclz, bchz, dlz, dhz, qmzx, qpzx, flzx, qzx, qaux, bcmz, cdir);
       // Z|Y
       pc_cmpflx(
-        i, j, k, bclz, bchz, dlz, dhz, qmzy, qpzy, flzy, qzy, qaux, cdir);
+        i, j, k, bclz, bchz, dlz, dhz, qmzy, qpzy, flzy, qzy, qaux, bcmz, cdir);
     });
 
   qzxmeli.clear();
@@ -351,8 +354,8 @@ pc_umeth_3D(
   qzypeli.clear();
 
   // Temp Fabs for Final Fluxes
-  amrex::FArrayBox qmfab(bxg2, QVAR);
-  amrex::FArrayBox qpfab(bxg1, QVAR);
+  amrex::FArrayBox qmfab = scratch.make_fab(bxg2, QVAR);
+  amrex::FArrayBox qpfab = scratch.make_fab(bxg1, QVAR);
   amrex::Elixir qmeli = qmfab.elixir();
   amrex::Elixir qpeli = qpfab.elixir();
   auto const& qm = qmfab.array();
@@ -376,7 +379,8 @@ pc_umeth_3D(
   qxpeli.clear();
   // Final X flux
   amrex::ParallelFor(xfxbx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-    pc_cmpflx(i, j, k, bclx, bchx, dlx, dhx, qm, qp, flx1, q1, qaux, cdir);
+    pc_cmpflx(
+      i, j, k, bclx, bchx, dlx, dhx, qm, qp, flx1, q1, qaux, bcmx, cdir);
   });
 
   // Y | X&Z
@@ -397,7 +401,8 @@ pc_umeth_3D(
   qypeli.clear();
   // Final Y flux
   amrex::ParallelFor(yfxbx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-    pc_cmpflx(i, j, k, bcly, bchy, dly, dhy, qm, qp, flx2, q2, qaux, cdir);
+    pc_cmpflx(
+      i, j, k, bcly, bchy, dly, dhy, qm, qp, flx2, q2, qaux, bcmy, cdir);
   });
 
   // Z | X&Y
@@ -418,7 +423,8 @@ pc_umeth_3D(
   qzpeli.clear();
   // Final Z flux
   amrex::ParallelFor(zfxbx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-    pc_cmpflx(i, j, k, bclz, bchz, dlz, dhz, qm, qp, flx3, q3, qaux, cdir);
+    pc_cmpflx(
+      i, j, k, bclz, bchz, dlz, dhz, qm, qp, flx3, q3, qaux, bcmz, cdir);
   });
 
   qmeli.clear();
@@ -439,8 +445,8 @@ pc_umeth_2D(
   const int* domhi,
   amrex::Array4<const amrex::Real> const& q,
   amrex::Array4<const amrex::Real> const& qaux,
-  amrex::Array4<const amrex::Real> const&
-    srcQ, // amrex::IArrayBox const& bcMask,
+  amrex::Array4<const amrex::Real> const& srcQ,
+  const amrex::GpuArray<amrex::Array4<const int>, AMREX_SPACEDIM>& bcMask,
   amrex::Array4<amrex::Real> const& flx1,
   amrex::Array4<amrex::Real> const& flx2,
   // amrex::Array4<const amrex::Real> const& dloga,
@@ -453,7 +459,8 @@ pc_umeth_2D(
   const amrex::Real* del,
   const amrex::Real dt,
   const int ppm_type,
-  const int use_flattening)
+  const int use_flattening,
+  ScratchArena& scratch)
 {
 #if AMREX_SPACEDIM == 2
   {
@@ -472,7 +479,8 @@ pc_umeth_2D(
     const int dhx = domhi[0];
     const int dhy = domhi[1];
 
-    // auto const& bcMaskarr = bcMask.array();
+    auto const& bcmx = bcMask[0];
+    auto const& bcmy = bcMask[1];
     const amrex::Box& bxg1 = grow(bx, 1);
     const amrex::Box& bxg2 = grow(bx, 2);
 
@@ -480,8 +488,8 @@ pc_umeth_2D(
     int cdir = 0;
     const amrex::Box& xslpbx = grow(bxg1, cdir, 1);
     const amrex::Box& xmbx = growHi(xslpbx, cdir, 1);
-    amrex::FArrayBox qxm(xmbx, QVAR);
-    amrex::FArrayBox qxp(xslpbx, QVAR);
+    amrex::FArrayBox qxm = scratch.make_fab(xmbx, QVAR);
+    amrex::FArrayBox qxp = scratch.make_fab(xslpbx, QVAR);
     amrex::Elixir qxmeli = qxm.elixir();
     amrex::Elixir qxpeli = qxp.elixir();
     auto const& qxmarr = qxm.array();
@@ -492,8 +500,8 @@ pc_umeth_2D(
     const amrex::Box& yflxbx = surroundingNodes(bxg1, cdir);
     const amrex::Box& yslpbx = grow(bxg1, cdir, 1);
     const amrex::Box& ymbx = growHi(yslpbx, cdir, 1);
-    amrex::FArrayBox qym(ymbx, QVAR);
-    amrex::FArrayBox qyp(yslpbx, QVAR);
+    amrex::FArrayBox qym = scratch.make_fab(ymbx, QVAR);
+    amrex::FArrayBox qyp = scratch.make_fab(yslpbx, QVAR);
     amrex::Elixir qymeli = qym.elixir();
     amrex::Elixir qypeli = qyp.elixir();
     auto const& qymarr = qym.array();
@@ -521,36 +529,37 @@ pc_umeth_2D(
     // method X initial fluxes
     cdir = 0;
     const amrex::Box& xflxbx = surroundingNodes(bxg1, cdir);
-    amrex::FArrayBox fx(xflxbx, NVAR);
+    amrex::FArrayBox fx = scratch.make_fab(xflxbx, NVAR);
     amrex::Elixir fxeli = fx.elixir();
     auto const& fxarr = fx.array();
-    amrex::FArrayBox qgdx(bxg2, NGDNV);
+    amrex::FArrayBox qgdx = scratch.make_fab(bxg2, NGDNV);
     amrex::Elixir qgdxeli = qgdx.elixir();
     auto const& gdtemp = qgdx.array();
     amrex::ParallelFor(
       xflxbx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
         pc_cmpflx(
           i, j, k, bclx, bchx, dlx, dhx, qxmarr, qxparr, fxarr, gdtemp, qaux,
-          cdir);
+          bcmx, cdir);
       });
 
     // Y initial fluxes
     cdir = 1;
-    amrex::FArrayBox fy(yflxbx, NVAR);
+    amrex::FArrayBox fy = scratch.make_fab(yflxbx, NVAR);
     amrex::Elixir fyeli = fy.elixir();
     auto const& fyarr = fy.array();
     amrex::ParallelFor(
       yflxbx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
         pc_cmpflx(
-          i, j, k, bcly, bchy, dly, dhy, qymarr, qyparr, fyarr, q2, qaux, cdir);
+          i, j, k, bcly, bchy, dly, dhy, qymarr, qyparr, fyarr, q2, qaux, bcmy,
+          cdir);
       });
 
     // X interface corrections
     cdir = 0;
     const amrex::Box& tybx = grow(bx, cdir, 1);
-    amrex::FArrayBox qm(bxg2, QVAR);
+    amrex::FArrayBox qm = scratch.make_fab(bxg2, QVAR);
     amrex::Elixir qmeli = qm.elixir();
-    amrex::FArrayBox qp(bxg1, QVAR);
+    amrex::FArrayBox qp = scratch.make_fab(bxg1, QVAR);
     amrex::Elixir qpeli = qp.elixir();
     auto const& qmarr = qm.array();
     auto const& qparr = qp.array();
@@ -571,7 +580,8 @@ pc_umeth_2D(
     amrex::ParallelFor(
       xfxbx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
         pc_cmpflx(
-          i, j, k, bclx, bchx, dlx, dhx, qmarr, qparr, flx1, q1, qaux, cdir);
+          i, j, k, bclx, bchx, dlx, dhx, qmarr, qparr, flx1, q1, qaux, bcmx,
+          cdir);
       });
 
     // Y interface corrections
@@ -593,7 +603,8 @@ pc_umeth_2D(
     amrex::ParallelFor(
       yfxbx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
         pc_cmpflx(
-          i, j, k, bcly, bchy, dly, dhy, qmarr, qparr, flx2, q2, qaux, cdir);
+          i, j, k, bcly, bchy, dly, dhy, qmarr, qparr, flx2, q2, qaux, bcmy,
+          cdir);
       });
 
     // Construct p div{U}
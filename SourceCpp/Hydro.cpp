@@ -90,10 +90,8 @@ PeleC::construct_hydro_source(
     reduction(max:courno)
 #endif
     {
-      // amrex::IArrayBox bcMask[AMREX_SPACEDIM];
       amrex::Real cflLoc = -1.0e+200;
       int is_finest_level = (level == finest_level) ? 1 : 0;
-      int flag_nscbc_isAnyPerio = (geom.isAnyPeriodic()) ? 1 : 0;
       int flag_nscbc_perio[AMREX_SPACEDIM]; // For 3D, we will know which
                                             // corners have a periodicity
       for (int dir = 0; dir < AMREX_SPACEDIM; ++dir) {
@@ -103,10 +101,22 @@ PeleC::construct_hydro_source(
 
       const int* domain_lo = geom.Domain().loVect();
       const int* domain_hi = geom.Domain().hiVect();
+      const bool from_cache =
+        use_prim_cache && Sborder_from_cache && &S == &Sborder;
 
-      // Temporary Fabs needed for Hydro Computation
-      for (amrex::MFIter mfi(S_new, amrex::TilingIfNotGPU()); mfi.isValid();
-           ++mfi) {
+#ifdef _OPENMP
+      const int thread_id = omp_get_thread_num();
+#else
+      const int thread_id = 0;
+#endif
+
+      // Temporary Fabs needed for Hydro Computation. The tiles of a thread
+      // share its scratch arena and are kept on one GPU stream.
+      amrex::MFItInfo mfi_info = amrex::TilingIfNotGPU();
+      if (hydro_scratch[thread_id]->enabled()) {
+        mfi_info.SetNumStreams(1);
+      }
+      for (amrex::MFIter mfi(S_new, mfi_info); mfi.isValid(); ++mfi) {
 
         const amrex::Box& bx = mfi.tilebox();
         const amrex::Box& qbx = amrex::grow(bx, NUM_GROW + nGrowF);
@@ -114,11 +124,15 @@ PeleC::construct_hydro_source(
         const int* lo = bx.loVect();
         const int* hi = bx.hiVect();
 
+        // Temporaries for this tile come from the per-thread scratch arena
+        ScratchArena& scratch = *hydro_scratch[thread_id];
+        scratch.reset();
+
         amrex::GpuArray<amrex::FArrayBox, AMREX_SPACEDIM> flux;
         amrex::Elixir flux_eli[AMREX_SPACEDIM];
         for (int dir = 0; dir < AMREX_SPACEDIM; ++dir) {
           const amrex::Box& efbx = surroundingNodes(fbx, dir);
-          flux[dir].resize(efbx, NVAR);
+          flux[dir] = scratch.make_fab(efbx, NVAR);
           flux_eli[dir] = flux[dir].elixir();
         }
 
@@ -126,7 +140,9 @@ PeleC::construct_hydro_source(
         auto const& hyd_src = hydro_source.array(mfi);
 
         // Resize Temporary Fabs
-        amrex::FArrayBox q(qbx, QVAR), qaux(qbx, NQAUX), src_q(qbx, QVAR);
+        amrex::FArrayBox q = scratch.make_fab(qbx, QVAR);
+        amrex::FArrayBox qaux = scratch.make_fab(qbx, NQAUX);
+        amrex::FArrayBox src_q = scratch.make_fab(qbx, QVAR);
         // Use Elixir Construct to steal the Fabs metadata
         amrex::Elixir qeli = q.elixir();
         amrex::Elixir qauxeli = qaux.elixir();
@@ -136,55 +152,47 @@ PeleC::construct_hydro_source(
         auto const& qauxar = qaux.array();
         auto const& srcqarr = src_q.array();
 
-        BL_PROFILE_VAR("PeleC::ctoprim()", ctop);
-        amrex::ParallelFor(
-          qbx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-            pc_ctoprim(i, j, k, s, qarr, qauxar);
-          });
-        BL_PROFILE_VAR_STOP(ctop);
+        // The primitives are copied from the level cache when S was filled
+        // through it, the NSCBC below may still rewrite their ghost cells
+        if (from_cache) {
+          q.copy<amrex::RunOn::Device>(prim_cache.q()[mfi], qbx);
+          qaux.copy<amrex::RunOn::Device>(prim_cache.qaux()[mfi], qbx);
+        } else {
+          BL_PROFILE_VAR("PeleC::ctoprim()", ctop);
+          amrex::ParallelFor(
+            qbx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+              pc_ctoprim(i, j, k, s, qarr, qauxar);
+            });
+          BL_PROFILE_VAR_STOP(ctop);
+        }
 
-        // TODO GPUize NCSCBC
         // Imposing Ghost-Cells Navier-Stokes Characteristic BCs if "UserBC" are
-        // used For the theory, see Motheau et al. AIAA J. Vol. 55, No. 10 : pp.
-        // 3399-3408, 2017.
+        // used. For the theory, see Motheau et al. AIAA J. Vol. 55, No. 10 :
+        // pp. 3399-3408, 2017.
         //
-        // The user should provide a bcnormal routine in bc_fill_module with
-        // additional optional arguments to temporary fill ghost-cells for
-        // EXT_DIR and to provide target BC values. See the examples.
-
-        // Allocate fabs for bcMask. Note that we grow in the opposite direction
-        // because the Riemann solver wants a face value in a ghost-cell
-#if 0 
-      for (int dir = 0; dir < AMREX_SPACEDIM ; dir++)  {
-        const Box& bxtmp = amrex::surroundingNodes(fbx,dir);
-        Box TestBox(bxtmp);
-        for(int d=0; d<AMREX_SPACEDIM; ++d) {
-          if (dir!=d) TestBox.grow(d,1);
+        // The user should provide a bcnormal overload in prob.H with
+        // additional arguments returning the BC type and target values. See
+        // the PMF_NSCBC example. The mask is only allocated when the tile
+        // touches such a face, otherwise the Riemann solver gets an empty one.
+        amrex::IArrayBox bcMask[AMREX_SPACEDIM];
+        amrex::Elixir bcMask_eli[AMREX_SPACEDIM];
+        amrex::GpuArray<amrex::Array4<const int>, AMREX_SPACEDIM> bcm;
+        if (
+          nscbc_adv == 1 &&
+          pc_nscbc_needed(qbx, geom.Domain(), phys_bc.lo(), phys_bc.hi())) {
+          amrex::GpuArray<amrex::Array4<int>, AMREX_SPACEDIM> bcMaskarr;
+          for (int dir = 0; dir < AMREX_SPACEDIM; dir++) {
+            bcMask[dir].resize(amrex::surroundingNodes(qbx, dir), 1);
+            bcMask_eli[dir] = bcMask[dir].elixir();
+            bcMask[dir].setVal<amrex::RunOn::Device>(0);
+            bcMaskarr[dir] = bcMask[dir].array();
+            bcm[dir] = bcMask[dir].const_array();
+          }
+          pc_impose_NSCBC(
+            qbx, qarr, qauxar, bcMaskarr, phys_bc.lo(), phys_bc.hi(),
+            flag_nscbc_perio, geom, time);
         }
-        bcMask[dir].resize(TestBox,1);
-        bcMask[dir].setVal(0);
-      }
-      
-      // Becase bcMask is read in the Riemann solver in any case,
-      // here we put physbc values in the appropriate faces for the non-nscbc case
-      set_bc_mask(lo, hi, domain_lo, domain_hi,
-                  AMREX_D_DECL(AMREX_TO_FORTRAN(bcMask[0]),
-	                       AMREX_TO_FORTRAN(bcMask[1]),
-                         AMREX_TO_FORTRAN(bcMask[2])));
-
-      if (nscbc_adv == 1)
-      {
-        impose_NSCBC(lo, hi, domain_lo, domain_hi,
-                     AMREX_TO_FORTRAN(*statein),
-                     AMREX_TO_FORTRAN(q.fab()),
-                     AMREX_TO_FORTRAN(qaux.fab()),
-                     AMREX_D_DECL(AMREX_TO_FORTRAN(bcMask[0]),
-                            AMREX_TO_FORTRAN(bcMask[1]),
-                            AMREX_TO_FORTRAN(bcMask[2])),
-                     &flag_nscbc_isAnyPerio, flag_nscbc_perio, 
-                     &time, dx, &dt);
-      }
-#endif
+
         BL_PROFILE_VAR("PeleC::srctoprim()", srctop);
         const auto& src_in = sources_for_hydro.array(mfi);
         amrex::ParallelFor(
@@ -193,10 +201,11 @@ PeleC::construct_hydro_source(
           });
         BL_PROFILE_VAR_STOP(srctop);
 
-        amrex::FArrayBox pradial(amrex::Box::TheUnitBox(), 1);
-        if (!amrex::DefaultGeometry().IsCartesian()) {
-          pradial.resize(amrex::surroundingNodes(bx, 0), 1);
-        }
+        amrex::FArrayBox pradial = scratch.make_fab(
+          amrex::DefaultGeometry().IsCartesian()
+            ? amrex::Box::TheUnitBox()
+            : amrex::surroundingNodes(bx, 0),
+          1);
         amrex::Elixir pradial_eli = pradial.elixir();
 
 #ifdef AMREX_USE_GPU
@@ -214,8 +223,9 @@ PeleC::construct_hydro_source(
             area[0].array(mfi), area[1].array(mfi), area[2].array(mfi))};
         pc_umdrv(
           is_finest_level, time, bx, domain_lo, domain_hi, phys_bc.lo(),
-          phys_bc.hi(), s, hyd_src, qarr, qauxar, srcqarr, dx, dt, ppm_type,
-          use_flattening, flx_arr, a, volume.array(mfi), cflLoc);
+          phys_bc.hi(), s, hyd_src, qarr, qauxar, srcqarr, bcm, dx, dt,
+          ppm_type, use_flattening, flx_arr, a, volume.array(mfi), cflLoc,
+          scratch);
         BL_PROFILE_VAR_STOP(purm);
 
         BL_PROFILE_VAR("courno + flux reg", crno);
@@ -225,7 +235,7 @@ PeleC::construct_hydro_source(
         if (use_explicit_filter) {
           for (int dir = 0; dir < AMREX_SPACEDIM; dir++) {
             const amrex::Box& bxtmp = amrex::surroundingNodes(bx, dir);
-            amrex::FArrayBox filtered_flux(bxtmp, NVAR);
+            amrex::FArrayBox filtered_flux = scratch.make_fab(bxtmp, NVAR);
             amrex::Elixir filtered_flux_eli = filtered_flux.elixir();
             les_filter.apply_filter(
               bxtmp, flux[dir], filtered_flux, Density, NVAR);
@@ -235,7 +245,7 @@ PeleC::construct_hydro_source(
               bxtmp, flux[dir].nComp(), filtered_flux.array(), flx_arr[dir]);
           }
 
-          amrex::FArrayBox filtered_source_out(bx, NVAR);
+          amrex::FArrayBox filtered_source_out = scratch.make_fab(bx, NVAR);
           amrex::Elixir filtered_source_out_eli = filtered_source_out.elixir();
           les_filter.apply_filter(
             bx, hydro_source[mfi], filtered_source_out, Density, NVAR);
@@ -274,6 +284,17 @@ PeleC::construct_hydro_source(
 
     BL_PROFILE_VAR_STOP(PC_UMDRV);
 
+    long scratch_bytes = 0;
+    for (const auto& arena : hydro_scratch) {
+      scratch_bytes += arena->bytesAllocated();
+      arena->clearBytesAllocated();
+    }
+    if (verbose) {
+      amrex::ParallelDescriptor::ReduceLongSum(scratch_bytes);
+      amrex::Print() << "... hydro temporaries allocated " << scratch_bytes
+                     << " bytes at level " << level << std::endl;
+    }
+
     if (track_grid_losses) {
       material_lost_through_boundary_temp[0] += mass_lost;
       material_lost_through_boundary_temp[1] += xmom_lost;
@@ -342,8 +363,8 @@ pc_umdrv(
   amrex::Array4<amrex::Real> const& uout,
   amrex::Array4<const amrex::Real> const& q,
   amrex::Array4<const amrex::Real> const& qaux,
-  amrex::Array4<const amrex::Real> const&
-    src_q, // amrex::IArrayBox const& bcMask,
+  amrex::Array4<const amrex::Real> const& src_q,
+  const amrex::GpuArray<amrex::Array4<const int>, AMREX_SPACEDIM>& bcMask,
   const amrex::Real* dx,
   const amrex::Real dt,
   const int ppm_type,
@@ -352,7 +373,8 @@ pc_umdrv(
   const amrex::GpuArray<const amrex::Array4<const amrex::Real>, AMREX_SPACEDIM>
     a,
   amrex::Array4<amrex::Real> const& vol,
-  amrex::Real cflLoc)
+  amrex::Real cflLoc,
+  ScratchArena& scratch)
 {
   //  Set Up for Hydro Flux Calculations
   auto const& bxg2 = grow(bx, 2);
@@ -360,15 +382,15 @@ pc_umdrv(
   amrex::Elixir qec_eli[AMREX_SPACEDIM];
   for (int dir = 0; dir < AMREX_SPACEDIM; dir++) {
     const amrex::Box eboxes = amrex::surroundingNodes(bxg2, dir);
-    qec[dir].resize(eboxes, NGDNV);
+    qec[dir] = scratch.make_fab(eboxes, NGDNV);
     qec_eli[dir] = qec[dir].elixir();
   }
   amrex::GpuArray<amrex::Array4<amrex::Real>, AMREX_SPACEDIM> qec_arr{
     AMREX_D_DECL(qec[0].array(), qec[1].array(), qec[2].array())};
 
   //  Temporary FArrayBoxes
-  amrex::FArrayBox divu(bxg2, 1);
-  amrex::FArrayBox pdivu(bx, 1);
+  amrex::FArrayBox divu = scratch.make_fab(bxg2, 1);
+  amrex::FArrayBox pdivu = scratch.make_fab(bx, 1);
   amrex::Elixir divueli = divu.elixir();
   amrex::Elixir pdiveli = pdivu.elixir();
   auto const& divarr = divu.array();
@@ -378,18 +400,18 @@ pc_umdrv(
 #if AMREX_SPACEDIM == 1
   amrex::Abort("PLM isn't implemented in 1D.");
   // pc_umeth_1D(
-  //  bx, bclo, bchi, domlo, domhi, q, qaux, src_q, // bcMask,
+  //  bx, bclo, bchi, domlo, domhi, q, qaux, src_q, bcMask,
   //  flx[0], qec_arr[0], a[0], pdivuarr, vol, dx, dt);
 #elif AMREX_SPACEDIM == 2
   pc_umeth_2D(
-    bx, bclo, bchi, domlo, domhi, q, qaux, src_q, // bcMask,
+    bx, bclo, bchi, domlo, domhi, q, qaux, src_q, bcMask,
     flx[0], flx[1], qec_arr[0], qec_arr[1], a[0], a[1], pdivuarr, vol, dx, dt,
-    ppm_type, use_flattening);
+    ppm_type, use_flattening, scratch);
 #elif AMREX_SPACEDIM == 3
   pc_umeth_3D(
-    bx, bclo, bchi, domlo, domhi, q, qaux, src_q, // bcMask,
+    bx, bclo, bchi, domlo, domhi, q, qaux, src_q, bcMask,
     flx[0], flx[1], flx[2], qec_arr[0], qec_arr[1], qec_arr[2], a[0], a[1],
-    a[2], pdivuarr, vol, dx, dt, ppm_type, use_flattening);
+    a[2], pdivuarr, vol, dx, dt, ppm_type, use_flattening, scratch);
 #endif
   BL_PROFILE_VAR_STOP(umeth);
   for (int dir = 0; dir < AMREX_SPACEDIM; dir++) {
@@ -440,3 +462,65 @@ pc_consup(
     pc_update(i, j, k, update, flx, vol, pdivu);
   });
 }
+
+/**
+ * Upper estimate of the number of Reals needed by the hydro temporaries of
+ * one tile. Nothing is released from the arena before the end of a tile, so
+ * every temporary of pc_umeth counts.
+ */
+static std::size_t
+hydro_scratch_size(
+  const amrex::Box& bx, const int ngrow_filter, const bool filtered)
+{
+  const amrex::Box qbx = amrex::grow(bx, NUM_GROW + ngrow_filter);
+  const amrex::Box fbx = amrex::grow(bx, ngrow_filter + 1);
+  const amrex::Box bxg3 = amrex::grow(bx, 3);
+
+  std::size_t nreal = (2 * QVAR + NQAUX) * qbx.numPts();
+  nreal += AMREX_SPACEDIM * NVAR * fbx.numPts();
+  nreal += (AMREX_SPACEDIM * NGDNV + 2) * bxg3.numPts();
+#if AMREX_SPACEDIM == 3
+  nreal += (20 * QVAR + 9 * NVAR + 9 * NGDNV) * bxg3.numPts();
+#else
+  nreal += (6 * QVAR + 2 * NVAR + NGDNV) * bxg3.numPts();
+#endif
+  if (filtered) {
+    nreal += (AMREX_SPACEDIM + 1) * NVAR * fbx.numPts();
+  }
+  return nreal;
+}
+
+/**
+ * Build the per-thread scratch arenas for the hydro tile loop, sized for
+ * the largest tile on this level.
+ */
+void
+PeleC::init_hydro_scratch()
+{
+#ifdef _OPENMP
+  const int nthreads = omp_get_max_threads();
+#else
+  const int nthreads = 1;
+#endif
+  hydro_scratch.resize(nthreads);
+  for (auto& arena : hydro_scratch) {
+    if (!arena) {
+      arena.reset(new ScratchArena());
+    }
+  }
+
+  std::size_t nreal = 0;
+  const bool enabled = (hydro_scratch_arena != 0) && do_hydro && !do_mol;
+  if (enabled) {
+    for (amrex::MFIter mfi(grids, dmap, amrex::TilingIfNotGPU());
+         mfi.isValid(); ++mfi) {
+      nreal = amrex::max(
+        nreal,
+        hydro_scratch_size(mfi.tilebox(), nGrowF, use_explicit_filter != 0));
+    }
+  }
+
+  for (auto& arena : hydro_scratch) {
+    arena->define(enabled, nreal);
+  }
+}
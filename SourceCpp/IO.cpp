@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <iomanip>
 #include <iostream>
 #include <string>
@@ -10,6 +11,7 @@
 #include <AMReX_Utility.H>
 #include <AMReX_buildInfo.H>
 #include <AMReX_ParmParse.H>
+#include <AMReX_AsyncOut.H>
 #ifdef PELEC_USE_EB
 #include <AMReX_EBMultiFabUtil.H>
 #endif
@@ -21,6 +23,7 @@
 
 #include "PeleC.H"
 #include "IO.H"
+#include "PltCompress.H"
 #include "IndexDefines.H"
 
 // PeleC maintains an internal checkpoint version numbering system.
@@ -37,6 +40,105 @@ int input_version = -1;
 int current_version = 1;
 std::string body_state_filename = "body_state.fab";
 amrex::Real vfraceps = 0.000001;
+
+// Number of files written by io_aggregators_per_node ranks on each node,
+// counted once since it needs a collective
+int
+aggregated_nfiles(const int per_node)
+{
+  static int nnodes = -1;
+  if (nnodes < 0) {
+    nnodes = 1;
+#ifdef BL_USE_MPI
+    MPI_Comm node_comm;
+    MPI_Comm_split_type(
+      amrex::ParallelDescriptor::Communicator(), MPI_COMM_TYPE_SHARED,
+      amrex::ParallelDescriptor::MyProc(), MPI_INFO_NULL, &node_comm);
+    int node_rank = 0;
+    MPI_Comm_rank(node_comm, &node_rank);
+    MPI_Comm_free(&node_comm);
+    nnodes = (node_rank == 0) ? 1 : 0;
+    amrex::ParallelDescriptor::ReduceIntSum(nnodes);
+#endif
+  }
+  return amrex::max(
+    1, amrex::min(nnodes * per_node, amrex::ParallelDescriptor::NProcs()));
+}
+
+// Write a plot MultiFab, handing it over to the background writer when
+// asynchronous output is on (amrex.async_out = 1) so that the time stepping
+// carries on while it drains to disk
+void
+write_plot_multifab(
+  amrex::MultiFab&& plotMF,
+  const std::string& name,
+  amrex::VisMF::How how,
+  const int aggregators_per_node)
+{
+  if (aggregators_per_node > 0) {
+    amrex::VisMF::SetNOutFiles(aggregated_nfiles(aggregators_per_node));
+  }
+  if (amrex::AsyncOut::UseAsyncOut()) {
+    amrex::VisMF::AsyncWrite(std::move(plotMF), name);
+  } else {
+    amrex::VisMF::Write(plotMF, name, how, true);
+  }
+}
+
+// Codec and tolerance of each plot variable: pelec.plot_codec for all of
+// them, unless listed in pelec.plot_<codec>_vars. pelec.plot_quantized_tol
+// holds one tolerance, or one for each of pelec.plot_quantized_vars.
+void
+plot_codecs(
+  const amrex::Vector<std::string>& names,
+  amrex::Vector<int>& codecs,
+  amrex::Vector<amrex::Real>& tols)
+{
+  amrex::ParmParse pp("pelec");
+  std::string codec = "lossless";
+  pp.query("plot_codec", codec);
+  const int dflt = pltcompress::codec_from_name(codec);
+  if (dflt < 0) {
+    amrex::Abort("pelec.plot_codec: unknown codec " + codec);
+  }
+  amrex::Vector<amrex::Real> qtols;
+  pp.queryarr("plot_quantized_tol", qtols);
+  const amrex::Real qtol = qtols.empty() ? 0.0 : qtols[0];
+
+  codecs.assign(names.size(), dflt);
+  tols.assign(names.size(), (dflt == pltcompress::quantized) ? qtol : 0.0);
+  for (int c = 0; c < pltcompress::num_codec_types; c++) {
+    amrex::Vector<std::string> vars;
+    const std::string key = "plot_" + pltcompress::codec_name(c) + "_vars";
+    pp.queryarr(key.c_str(), vars);
+    if (
+      c == pltcompress::quantized && qtols.size() > 1 &&
+      qtols.size() != vars.size()) {
+      amrex::Abort(
+        "pelec.plot_quantized_tol needs one value or one per quantized var");
+    }
+    for (int v = 0; v < vars.size(); v++) {
+      const auto it = std::find(names.begin(), names.end(), vars[v]);
+      if (it == names.end()) {
+        amrex::Print() << "WARNING: pelec." << key << ": " << vars[v]
+                       << " is not a plot variable" << std::endl;
+        continue;
+      }
+      const int n = std::distance(names.begin(), it);
+      codecs[n] = c;
+      tols[n] = 0.0;
+      if (c == pltcompress::quantized) {
+        tols[n] = (qtols.size() > 1) ? qtols[v] : qtol;
+      }
+    }
+  }
+  for (int n = 0; n < names.size(); n++) {
+    if (codecs[n] == pltcompress::quantized && !(tols[n] > 0.0)) {
+      amrex::Abort(
+        "pelec.plot_quantized_tol must be positive for quantized " + names[n]);
+    }
+  }
+}
 } // namespace
 
 // I/O routines for PeleC
@@ -90,6 +192,10 @@ PeleC::restart(amrex::Amr& papa, istream& is, bool bReadSpecial)
   buildMetrics();
 
 #ifdef PELEC_USE_EB
+  // Sparse EB data saved with the checkpoint, if any, instead of recomputed.
+  // The EB2 index space it derives from is built from the geometry inputs
+  // before the restart, AMReX has no way here to read it back.
+  readEBCache(papa.theRestartFile() + "/EB");
   init_eb(geom, grids, dmap);
 #endif
 
@@ -242,6 +348,11 @@ PeleC::checkPoint(
   amrex::VisMF::How how,
   bool dump_old_default)
 {
+  // The state data goes through the AMReX writer, asynchronous with
+  // amrex.async_out = 1, over the aggregated files
+  if (io_aggregators_per_node > 0) {
+    amrex::VisMF::SetNOutFiles(aggregated_nfiles(io_aggregators_per_node));
+  }
   amrex::AmrLevel::checkPoint(dir, os, how, dump_old);
 
 #ifdef AMREX_PARTICLES
@@ -337,6 +448,12 @@ PeleC::checkPoint(
       BodyFile.close();
     }
   }
+
+  int checkpoint_cache = 0;
+  amrex::ParmParse("ebd").query("checkpoint_cache", checkpoint_cache);
+  if (checkpoint_cache != 0 && eb_in_domain) {
+    writeEBCache(dir + "/EB");
+  }
 #endif
 }
 
@@ -976,7 +1093,26 @@ PeleC::writePlotFile(const std::string& dir, ostream& os, amrex::VisMF::How how)
   //
   std::string TheFullPath = FullPath;
   TheFullPath += BaseName;
-  amrex::VisMF::Write(plotMF, TheFullPath, how, true);
+  if (plot_compress != 0) {
+    amrex::Vector<std::string> names;
+    for (i = 0; i < plot_var_map.size(); i++) {
+      names.push_back(
+        desc_lst[plot_var_map[i].first].name(plot_var_map[i].second));
+    }
+    for (const auto& name : derive_names) {
+      const amrex::DeriveRec* rec = derive_lst.get(name);
+      for (i = 0; i < rec->numDerive(); i++) {
+        names.push_back(rec->variableName(i));
+      }
+    }
+    amrex::Vector<int> codecs;
+    amrex::Vector<amrex::Real> tols;
+    plot_codecs(names, codecs, tols);
+    pltcompress::write_multifab(plotMF, TheFullPath, codecs, tols);
+  } else {
+    write_plot_multifab(
+      std::move(plotMF), TheFullPath, how, io_aggregators_per_node);
+  }
 #ifdef AMREX_PARTICLES
   bool is_checkpoint = false;
 
@@ -1158,5 +1294,6 @@ PeleC::writeSmallPlotFile(
   //
   std::string TheFullPath = FullPath;
   TheFullPath += BaseName;
-  amrex::VisMF::Write(plotMF, TheFullPath, how, true);
+  write_plot_multifab(
+    std::move(plotMF), TheFullPath, how, io_aggregators_per_node);
 }
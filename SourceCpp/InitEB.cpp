@@ -1,7 +1,141 @@
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <utility>
+
+#include <AMReX_OpenMP.H>
+#include <AMReX_Utility.H>
+
 #include "EB.H"
 #include "prob.H"
+#include "StlGeometry.H"
 #include "Utilities.H"
 
+namespace {
+
+// Sparse EB data of a grid, the flux interpolation stencils possibly
+// being empty
+struct EBGridData
+{
+  amrex::Gpu::DeviceVector<EBBndryGeom> bndry_geom;
+  amrex::Gpu::DeviceVector<EBBndrySten> bndry_grad_stencil;
+  amrex::GpuArray<amrex::Gpu::DeviceVector<FaceSten>, AMREX_SPACEDIM>
+    flux_interp_stencil;
+};
+
+// EB data of the local grids of the level being replaced, keyed by valid
+// box, or read from disk. It is reused as long as the geometry hash is
+// unchanged. The hash and disk_read are the same on all ranks, unlike the
+// local grids.
+struct EBLevelCache
+{
+  std::size_t geom_hash = 0;
+  bool disk_read = false;
+  std::map<amrex::Box, EBGridData> grids;
+};
+
+std::map<int, EBLevelCache> eb_cache;
+
+// The device vectors have to be freed before the arenas are, in
+// amrex::Finalize rather than with the static objects
+void
+clear_eb_cache()
+{
+  eb_cache.clear();
+}
+
+// Cache of a level, the first one created registering the clearing
+EBLevelCache&
+level_eb_cache(const int lev)
+{
+  if (eb_cache.empty()) {
+    amrex::ExecOnFinalize(clear_eb_cache);
+  }
+  return eb_cache[lev];
+}
+
+// Everything the sparse EB data of a grid depends on besides its box
+std::size_t
+eb_geom_hash(
+  const amrex::Geometry& geom, const int ngrow_tr, const int grad_stencil)
+{
+  std::ostringstream os;
+  os << std::setprecision(17) << geom.Domain() << ' ';
+  for (int d = 0; d < AMREX_SPACEDIM; d++) {
+    os << geom.CellSize(d) << ' ';
+  }
+  os << ngrow_tr << ' ' << grad_stencil << ' '
+     << static_cast<const void*>(amrex::EB2::TopIndexSpace());
+  return std::hash<std::string>{}(os.str());
+}
+
+const std::string eb_disk_version = "PeleC EB structs 1";
+
+// Key of the EB data written to disk: the level geometry and the EB inputs,
+// eb2.* and those of the geometry type
+std::string
+eb_disk_key(
+  const amrex::Geometry& geom, const int ngrow_tr, const int grad_stencil)
+{
+  std::ostringstream os;
+  os << std::setprecision(17) << geom.Domain();
+  for (int d = 0; d < AMREX_SPACEDIM; d++) {
+    os << ' ' << geom.ProbLo(d) << ' ' << geom.CellSize(d);
+  }
+  os << ' ' << ngrow_tr << ' ' << grad_stencil << '\n';
+
+  std::string geom_type("all_regular");
+  amrex::ParmParse("eb2").query("geom_type", geom_type);
+  const std::string geom_prefix = geom_type + ".";
+  std::ostringstream table;
+  amrex::ParmParse::dumpTable(table);
+  std::istringstream is(table.str());
+  std::string line;
+  while (std::getline(is, line)) {
+    if (
+      line.compare(0, 4, "eb2.") == 0 ||
+      line.compare(0, geom_prefix.size(), geom_prefix) == 0) {
+      os << line << '\n';
+    }
+  }
+  return std::to_string(std::hash<std::string>{}(os.str()));
+}
+
+template <class T>
+void
+append_vector(std::vector<char>& buf, const amrex::Gpu::DeviceVector<T>& v)
+{
+  const std::uint64_t n = v.size();
+  std::vector<T> h(n);
+  if (n > 0) {
+    amrex::Gpu::dtoh_memcpy(h.data(), v.data(), n * sizeof(T));
+  }
+  const char* pn = reinterpret_cast<const char*>(&n);
+  buf.insert(buf.end(), pn, pn + sizeof(n));
+  const char* ph = reinterpret_cast<const char*>(h.data());
+  buf.insert(buf.end(), ph, ph + n * sizeof(T));
+}
+
+template <class T>
+void
+read_vector(std::istream& is, amrex::Gpu::DeviceVector<T>& v)
+{
+  std::uint64_t n = 0;
+  is.read(reinterpret_cast<char*>(&n), sizeof(n));
+  std::vector<T> h(n);
+  is.read(reinterpret_cast<char*>(h.data()), n * sizeof(T));
+  v.resize(n);
+  if (n > 0) {
+    amrex::Gpu::htod_memcpy(v.data(), h.data(), n * sizeof(T));
+  }
+}
+
+} // namespace
+
 inline bool
 PeleC::ebInitialized()
 {
@@ -39,6 +173,7 @@ PeleC::initialize_eb2_structs()
 {
   BL_PROFILE("PeleC::initialize_eb2_structs()");
   amrex::Print() << "Initializing EB2 structs" << std::endl;
+  const amrex::Real t_start = amrex::ParallelDescriptor::second();
 
   // NOTE: THIS NEEDS TO BE REPLACED WITH A FLAGFAB
 
@@ -79,6 +214,54 @@ PeleC::initialize_eb2_structs()
   int bgs = -1;
   pp.get("boundary_grad_stencil_type", bgs);
 
+  // Grids already built for this level with the same geometry reuse their
+  // data instead of recomputing it
+  int cache_structs = 1;
+  pp.query("cache_structs", cache_structs);
+  EBLevelCache& cache = level_eb_cache(level);
+  const std::size_t geom_hash = eb_geom_hash(geom, nGrowTr, bgs);
+  if (cache.geom_hash != geom_hash) {
+    cache.grids.clear();
+    cache.geom_hash = geom_hash;
+    cache.disk_read = false;
+  }
+
+  // In a regrid, the level this one replaces is still in place and is
+  // deleted once it has filled the new state. Its data is moved to the cache
+  // so that it is never held twice on the device.
+  auto& amr_levels = parent->getAmrLevels();
+  if (
+    cache_structs != 0 && level < static_cast<int>(amr_levels.size()) &&
+    amr_levels[level] != nullptr && amr_levels[level].get() != this) {
+    auto& old = static_cast<PeleC&>(*amr_levels[level]);
+    for (amrex::MFIter mfi(old.grids, old.dmap); mfi.isValid(); ++mfi) {
+      const int iLocal = mfi.LocalIndex();
+      if (old.sv_eb_bndry_geom[iLocal].size() == 0) {
+        continue;
+      }
+      EBGridData& data = cache.grids[mfi.validbox()];
+      data.bndry_geom = std::move(old.sv_eb_bndry_geom[iLocal]);
+      data.bndry_grad_stencil = std::move(old.sv_eb_bndry_grad_stencil[iLocal]);
+      for (int dir = 0; dir < AMREX_SPACEDIM; ++dir) {
+        data.flux_interp_stencil[dir] =
+          std::move(old.flux_interp_stencil[dir][iLocal]);
+      }
+    }
+  }
+
+  // The first build of the level with this geometry also looks for the data
+  // on disk, and writes it there when it is missing or stale. Both are
+  // collective, so this is decided on the rank independent disk_read rather
+  // than on the local grids, which may be empty on some ranks only.
+  std::string cache_dir;
+  pp.query("cache_dir", cache_dir);
+  bool write_cache_dir = false;
+  if (!cache_dir.empty() && !cache.disk_read) {
+    write_cache_dir = !readEBCache(cache_dir);
+    cache.disk_read = true;
+  }
+  amrex::Vector<int> reused(vfrac.local_size(), 0);
+
 #ifdef _OPENMP
 #pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
 #endif
@@ -95,92 +278,90 @@ PeleC::initialize_eb2_structs()
     } else if (typ == amrex::FabType::covered) {
       mfab.setVal<amrex::RunOn::Device>(-1);
     } else if (typ == amrex::FabType::singlevalued) {
-      int Ncut = 0;
-      for (amrex::BoxIterator bit(tbox); bit.ok(); ++bit) {
-        const amrex::EBCellFlag& flag = flagfab(bit(), 0);
-
-        if (!(flag.isRegular() || flag.isCovered())) {
-          Ncut++;
-        }
-      }
+      auto const& flag_arr = flagfab.array();
+      auto const& mask_arr = mfab.array();
+      amrex::ParallelFor(
+        tbox & mfab.box(), [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+          const amrex::EBCellFlag& flag = flag_arr(i, j, k);
+          mask_arr(i, j, k) =
+            flag.isRegular() ? 1 : (flag.isCovered() ? -1 : 0);
+        });
 
-      sv_eb_bndry_geom[iLocal].resize(Ncut);
-      int ivec = 0;
-      for (amrex::BoxIterator bit(tbox); bit.ok(); ++bit) {
-        const amrex::EBCellFlag& flag = flagfab(bit(), 0);
-
-        if (!(flag.isRegular() || flag.isCovered())) {
-          EBBndryGeom* d_sv_eb_bndry_geom = sv_eb_bndry_geom[iLocal].data();
-          amrex::IntVect captured_bit = bit();
-          // Serial loop on the GPU
-          amrex::ParallelFor(1, [=] AMREX_GPU_DEVICE(int dummy) {
-            d_sv_eb_bndry_geom[ivec].iv = captured_bit;
+      const auto cached = cache.grids.find(mfi.validbox());
+      if (cached != cache.grids.end()) {
+        sv_eb_bndry_geom[iLocal] = std::move(cached->second.bndry_geom);
+        sv_eb_bndry_grad_stencil[iLocal] =
+          std::move(cached->second.bndry_grad_stencil);
+        reused[iLocal] = 1;
+      } else {
+        // Cut cells in box order, compacted one row of the tile per thread
+        const auto lo = amrex::lbound(tbox);
+        const auto len = amrex::length(tbox);
+        compact(
+          static_cast<int>(tbox.numPts()), len.x, sv_eb_bndry_geom[iLocal],
+          [=] AMREX_GPU_DEVICE(int n) noexcept -> int {
+            const int i = lo.x + n % len.x;
+            const int j = lo.y + (n / len.x) % len.y;
+            const int k = lo.z + n / (len.x * len.y);
+            const amrex::EBCellFlag& flag = flag_arr(i, j, k);
+            return (flag.isRegular() || flag.isCovered()) ? 0 : 1;
+          },
+          [=] AMREX_GPU_DEVICE(int n, EBBndryGeom* g) noexcept -> int {
+            const int i = lo.x + n % len.x;
+            const int j = lo.y + (n / len.x) % len.y;
+            const int k = lo.z + n / (len.x * len.y);
+            const amrex::EBCellFlag& flag = flag_arr(i, j, k);
+            if (flag.isRegular() || flag.isCovered()) {
+              return 0;
+            }
+            g->iv = amrex::IntVect(AMREX_D_DECL(i, j, k));
+            return 1;
           });
-          ivec++;
-
-          if (mfab.box().contains(bit()))
-            mfab(bit()) = 0;
+        const int Ncut = sv_eb_bndry_geom[iLocal].size();
+
+        // Now fill the sv_eb_bndry_geom
+        auto const& vfrac_arr = vfrac.array(mfi);
+        auto const& bndrycent_arr = bndrycent->array(mfi);
+        auto const& eb2areafrac_arr_0 = eb2areafrac[0]->array(mfi);
+        auto const& eb2areafrac_arr_1 = eb2areafrac[1]->array(mfi);
+        auto const& eb2areafrac_arr_2 = eb2areafrac[2]->array(mfi);
+        pc_fill_sv_ebg(
+          tbox, Ncut, vfrac_arr, bndrycent_arr,
+          AMREX_D_DECL(eb2areafrac_arr_0, eb2areafrac_arr_1, eb2areafrac_arr_2),
+          sv_eb_bndry_geom[iLocal].data());
+
+        sv_eb_bndry_grad_stencil[iLocal].resize(Ncut);
+
+        // Fill in boundary gradient for cut cells in this grown tile
+        const amrex::Real dx = geom.CellSize()[0];
+        sort<amrex::Gpu::DeviceVector<EBBndryGeom>>(sv_eb_bndry_geom[iLocal]);
+
+        if (bgs == 0) {
+          pc_fill_bndry_grad_stencil(
+            tbox, dx, Ncut, sv_eb_bndry_geom[iLocal].data(), Ncut,
+            sv_eb_bndry_grad_stencil[iLocal].data());
+        } else if (bgs == 1) {
+          amrex::Print() << "This gradient stencil type WIP and not functional!"
+                         << bgs << std::endl;
+          amrex::Abort();
+          // pc_fill_bndry_grad_stencil_amrex(AMREX_TO_FORTRAN_BOX(tbox),
+          //   sv_eb_bndry_geom[iLocal].data(), &Ncut,
+          //   sv_eb_bndry_grad_stencil[iLocal].data(), &Ncut, &dx);
+        } else if (bgs == 2) {
+          amrex::Print() << "This gradient stencil type WIP and not functional!"
+                         << bgs << std::endl;
+          amrex::Abort();
+          // pc_fill_bndry_grad_stencil_ls(AMREX_TO_FORTRAN_BOX(tbox),
+          //   sv_eb_bndry_geom[iLocal].data(), &Ncut,
+          //   sv_eb_bndry_grad_stencil[iLocal].data(), &Ncut, &dx);
         } else {
-          if (flag.isRegular()) {
-            if (mfab.box().contains(bit()))
-              mfab(bit()) = 1;
-          } else if (flag.isCovered()) {
-            if (mfab.box().contains(bit()))
-              mfab(bit()) = -1;
-          } else {
-            if (mfab.box().contains(bit()))
-              mfab(bit()) = 2;
-          }
+          amrex::Print()
+            << "Unknown or unspecified boundary gradient stencil type:" << bgs
+            << std::endl;
+          amrex::Abort();
         }
       }
 
-      int Nebg = sv_eb_bndry_geom[iLocal].size();
-
-      // Now fill the sv_eb_bndry_geom
-      auto const& vfrac_arr = vfrac.array(mfi);
-      auto const& bndrycent_arr = bndrycent->array(mfi);
-      auto const& eb2areafrac_arr_0 = eb2areafrac[0]->array(mfi);
-      auto const& eb2areafrac_arr_1 = eb2areafrac[1]->array(mfi);
-      auto const& eb2areafrac_arr_2 = eb2areafrac[2]->array(mfi);
-      pc_fill_sv_ebg(
-        tbox, Ncut, vfrac_arr, bndrycent_arr,
-        AMREX_D_DECL(eb2areafrac_arr_0, eb2areafrac_arr_1, eb2areafrac_arr_2),
-        sv_eb_bndry_geom[iLocal].data());
-
-      sv_eb_bndry_grad_stencil[iLocal].resize(Ncut);
-
-      // Fill in boundary gradient for cut cells in this grown tile
-      const amrex::Real dx = geom.CellSize()[0];
-      sort<amrex::Gpu::DeviceVector<EBBndryGeom>>(sv_eb_bndry_geom[iLocal]);
-
-      if (bgs == 0) {
-        pc_fill_bndry_grad_stencil(
-          tbox, dx, Ncut, sv_eb_bndry_geom[iLocal].data(), Ncut,
-          sv_eb_bndry_grad_stencil[iLocal].data());
-      } else if (bgs == 1) {
-        amrex::Print() << "This gradient stencil type WIP and not functional!"
-                       << bgs << std::endl;
-        amrex::Abort();
-        // pc_fill_bndry_grad_stencil_amrex(AMREX_TO_FORTRAN_BOX(tbox),
-        //                                 sv_eb_bndry_geom[iLocal].data(),
-        //                                 &Ncut,
-        //                                 sv_eb_bndry_grad_stencil[iLocal].data(),
-        //                                 &Ncut, &dx);
-      } else if (bgs == 2) {
-        amrex::Print() << "This gradient stencil type WIP and not functional!"
-                       << bgs << std::endl;
-        amrex::Abort();
-        // pc_fill_bndry_grad_stencil_ls(AMREX_TO_FORTRAN_BOX(tbox),
-        //                              sv_eb_bndry_geom[iLocal].data(), &Ncut,
-        //                              sv_eb_bndry_grad_stencil[iLocal].data(),
-        //                              &Ncut, &dx);
-      } else {
-        amrex::Print()
-          << "Unknown or unspecified boundary gradient stencil type:" << bgs
-          << std::endl;
-        amrex::Abort();
-      }
-
       sv_eb_flux[iLocal].define(sv_eb_bndry_grad_stencil[iLocal], NVAR);
       sv_eb_bcval[iLocal].define(sv_eb_bndry_grad_stencil[iLocal], QVAR);
 
@@ -223,6 +404,9 @@ PeleC::initialize_eb2_structs()
       int iLocal = mfi.LocalIndex();
 
       if (typ == amrex::FabType::regular || typ == amrex::FabType::covered) {
+      } else if (reused[iLocal] != 0) {
+        flux_interp_stencil[dir][iLocal] =
+          std::move(cache.grids.at(mfi.validbox()).flux_interp_stencil[dir]);
       } else if (typ == amrex::FabType::singlevalued) {
         const amrex::Box ebox = amrex::Box(tbox).surroundingNodes(dir);
         const auto afrac_arr = (*eb2areafrac[dir])[mfi].array();
@@ -230,45 +414,33 @@ PeleC::initialize_eb2_structs()
 
         // This used to be an std::set for cut_faces (it ensured
         // sorting and uniqueness)
-        EBBndryGeom* d_sv_eb_bndry_geom = sv_eb_bndry_geom[iLocal].data();
-        amrex::Gpu::LaunchSafeGuard lsg(true);
-        amrex::Gpu::DeviceScalar<int> ds(0);
-        int* dp = ds.dataPtr();
-        amrex::VecReduce(
-          sv_eb_bndry_geom[iLocal].size(), 0,
-          [=] AMREX_GPU_DEVICE(int i, int* r) noexcept {
+        const EBBndryGeom* d_sv_eb_bndry_geom = sv_eb_bndry_geom[iLocal].data();
+        amrex::Gpu::DeviceVector<amrex::IntVect> v_all_cut_faces;
+        compact(
+          sv_eb_bndry_geom[iLocal].size(), 64, v_all_cut_faces,
+          [=] AMREX_GPU_DEVICE(int i) noexcept -> int {
             const amrex::IntVect& iv = d_sv_eb_bndry_geom[i].iv;
+            int cnt = 0;
             for (int iside = 0; iside <= 1; iside++) {
               const amrex::IntVect iv_face = iv + iside * amrex::BASISV(dir);
               if (afrac_arr(iv_face) < 1.0) {
-                *r += 1;
+                cnt++;
               }
             }
+            return cnt;
           },
-          [=] AMREX_GPU_DEVICE(int const& r) noexcept {
-            amrex::Gpu::deviceReduceSum(dp, r);
-          });
-        const int Nall_cut_faces = ds.dataValue();
-
-        amrex::Gpu::DeviceVector<amrex::IntVect> v_all_cut_faces(
-          Nall_cut_faces);
-        amrex::IntVect* all_cut_faces = v_all_cut_faces.data();
-
-        const int sv_eb_bndry_geom_size = sv_eb_bndry_geom[iLocal].size();
-        // Serial loop on the GPU
-        amrex::ParallelFor(1, [=] AMREX_GPU_DEVICE(int dummy) {
-          int cnt = 0;
-          for (int i = 0; i < sv_eb_bndry_geom_size; i++) {
+          [=] AMREX_GPU_DEVICE(int i, amrex::IntVect* faces) noexcept -> int {
             const amrex::IntVect& iv = d_sv_eb_bndry_geom[i].iv;
+            int cnt = 0;
             for (int iside = 0; iside <= 1; iside++) {
               const amrex::IntVect iv_face = iv + iside * amrex::BASISV(dir);
               if (afrac_arr(iv_face) < 1.0) {
-                all_cut_faces[cnt] = iv_face;
+                faces[cnt] = iv_face;
                 cnt++;
               }
             }
-          }
-        });
+            return cnt;
+          });
         sort<amrex::Gpu::DeviceVector<amrex::IntVect>>(v_all_cut_faces);
         // ensure uniqueness
         amrex::Gpu::DeviceVector<amrex::IntVect> v_cut_faces =
@@ -294,6 +466,214 @@ PeleC::initialize_eb2_structs()
       }
     }
   }
+
+  // Scratch of the redistribution, one per fab when the fabs are not tiled,
+  // sized here so the time steps do not allocate, one per thread otherwise
+  sv_eb_redist_scratch.resize(
+    std::max(vfrac.local_size(), amrex::OpenMP::get_max_threads()));
+  if (amrex::Gpu::inLaunchRegion()) {
+    for (int iLocal = 0; iLocal < vfrac.local_size(); ++iLocal) {
+      sv_eb_redist_scratch[iLocal].resize(
+        2 * NVAR * sv_eb_bndry_geom[iLocal].size());
+    }
+  }
+
+  // The data of the grids that were not reused is freed, the current grids
+  // give theirs to the cache when they are replaced
+  cache.grids.clear();
+  int ncut_grids = 0;
+  int nreused = 0;
+  for (int iLocal = 0; iLocal < vfrac.local_size(); ++iLocal) {
+    if (sv_eb_bndry_geom[iLocal].size() > 0) {
+      ncut_grids++;
+      nreused += reused[iLocal];
+    }
+  }
+
+  if (write_cache_dir) {
+    writeEBCache(cache_dir);
+  }
+
+  if (verbose > 0) {
+    amrex::Real t_eb = amrex::ParallelDescriptor::second() - t_start;
+    amrex::ParallelDescriptor::ReduceRealMax(
+      t_eb, amrex::ParallelDescriptor::IOProcessorNumber());
+    amrex::ParallelDescriptor::ReduceIntSum(
+      ncut_grids, amrex::ParallelDescriptor::IOProcessorNumber());
+    amrex::ParallelDescriptor::ReduceIntSum(
+      nreused, amrex::ParallelDescriptor::IOProcessorNumber());
+    amrex::Print() << "Level " << level << " EB2 structs initialized in "
+                   << t_eb << " s, " << nreused << " of " << ncut_grids
+                   << " cut grids reused" << std::endl;
+  }
+}
+
+void
+PeleC::writeEBCache(const std::string& dir)
+{
+  BL_PROFILE("PeleC::writeEBCache()");
+  amrex::ParmParse pp("ebd");
+  int bgs = -1;
+  pp.get("boundary_grad_stencil_type", bgs);
+
+  const std::string name = dir + "/Level_" + std::to_string(level);
+  if (amrex::ParallelDescriptor::IOProcessor()) {
+    if (!amrex::UtilCreateDirectory(name, 0755)) {
+      amrex::CreateDirectoryFailed(name);
+    }
+  }
+  amrex::ParallelDescriptor::Barrier();
+
+  // Blocks of the local cut grids, each vector preceded by its size. The
+  // grids without cut cells have a negative offset.
+  std::vector<char> buf;
+  const int nfabs = grids.size();
+  amrex::Vector<long> offsets(nfabs, 0);
+  for (amrex::MFIter mfi(grids, dmap); mfi.isValid(); ++mfi) {
+    const int iLocal = mfi.LocalIndex();
+    if (sv_eb_bndry_geom[iLocal].size() == 0) {
+      offsets[mfi.index()] = -1;
+      continue;
+    }
+    offsets[mfi.index()] = buf.size();
+    append_vector(buf, sv_eb_bndry_geom[iLocal]);
+    append_vector(buf, sv_eb_bndry_grad_stencil[iLocal]);
+    for (int dir = 0; dir < AMREX_SPACEDIM; ++dir) {
+      append_vector(buf, flux_interp_stencil[dir][iLocal]);
+    }
+  }
+  if (!buf.empty()) {
+    const std::string fname = amrex::Concatenate(
+      name + "/Data_", amrex::ParallelDescriptor::MyProc(), 5);
+    std::ofstream ofs(fname.c_str(), std::ios::out | std::ios::binary);
+    if (!ofs.good()) {
+      amrex::FileOpenFailed(fname);
+    }
+    ofs.write(buf.data(), buf.size());
+  }
+
+  amrex::ParallelDescriptor::ReduceLongSum(
+    offsets.dataPtr(), nfabs, amrex::ParallelDescriptor::IOProcessorNumber());
+  if (amrex::ParallelDescriptor::IOProcessor()) {
+    const std::string hname = name + "/Header";
+    std::ofstream ofs(hname.c_str());
+    if (!ofs.good()) {
+      amrex::FileOpenFailed(hname);
+    }
+    ofs << eb_disk_version << '\n'
+        << eb_disk_key(geom, nGrowTr, bgs) << '\n'
+        << nfabs << '\n';
+    for (int i = 0; i < nfabs; i++) {
+      ofs << dmap[i] << ' ' << offsets[i] << '\n';
+    }
+    grids.writeOn(ofs);
+    ofs << '\n';
+  }
+  amrex::ParallelDescriptor::Barrier();
+
+  if (verbose > 0) {
+    amrex::Print() << "Level " << level << " EB2 structs written to " << name
+                   << std::endl;
+  }
+}
+
+bool
+PeleC::readEBCache(const std::string& dir)
+{
+  BL_PROFILE("PeleC::readEBCache()");
+  amrex::ParmParse pp("ebd");
+  int bgs = -1;
+  pp.get("boundary_grad_stencil_type", bgs);
+
+  const std::string name = dir + "/Level_" + std::to_string(level);
+  const std::string hname = name + "/Header";
+  int found = 0;
+  if (amrex::ParallelDescriptor::IOProcessor()) {
+    std::ifstream ifs(hname.c_str());
+    found = ifs.good() ? 1 : 0;
+  }
+  amrex::ParallelDescriptor::Bcast(
+    &found, 1, amrex::ParallelDescriptor::IOProcessorNumber());
+  if (found == 0) {
+    return false;
+  }
+
+  amrex::Vector<char> hbuf;
+  amrex::ParallelDescriptor::ReadAndBcastFile(hname, hbuf);
+  std::istringstream is(std::string(hbuf.dataPtr()), std::istringstream::in);
+  std::string version;
+  std::string key;
+  std::getline(is, version);
+  std::getline(is, key);
+  if (version != eb_disk_version || key != eb_disk_key(geom, nGrowTr, bgs)) {
+    if (verbose > 0) {
+      amrex::Print() << "Level " << level << " EB2 structs in " << name
+                     << " do not match the EB inputs, not read" << std::endl;
+    }
+    return false;
+  }
+  int nfabs = 0;
+  is >> nfabs;
+  amrex::Vector<int> owner(nfabs);
+  amrex::Vector<long> offsets(nfabs);
+  for (int i = 0; i < nfabs; i++) {
+    is >> owner[i] >> offsets[i];
+  }
+  amrex::BoxArray ba;
+  ba.readFrom(is);
+  AMREX_ALWAYS_ASSERT(static_cast<int>(ba.size()) == nfabs);
+  std::map<amrex::Box, int> index;
+  for (int i = 0; i < nfabs; i++) {
+    index[ba[i]] = i;
+  }
+
+  // Filled as if the grids had been built before with this geometry
+  EBLevelCache& cache = level_eb_cache(level);
+  cache.grids.clear();
+  cache.geom_hash = eb_geom_hash(geom, nGrowTr, bgs);
+  cache.disk_read = true;
+  for (amrex::MFIter mfi(grids, dmap); mfi.isValid(); ++mfi) {
+    const auto it = index.find(mfi.validbox());
+    if (it == index.end() || offsets[it->second] < 0) {
+      continue;
+    }
+    const int i = it->second;
+    const std::string fname = amrex::Concatenate(name + "/Data_", owner[i], 5);
+    std::ifstream ifs(fname.c_str(), std::ios::in | std::ios::binary);
+    if (!ifs.good()) {
+      amrex::FileOpenFailed(fname);
+    }
+    ifs.seekg(offsets[i]);
+    EBGridData& data = cache.grids[mfi.validbox()];
+    read_vector(ifs, data.bndry_geom);
+    read_vector(ifs, data.bndry_grad_stencil);
+    for (int dir = 0; dir < AMREX_SPACEDIM; ++dir) {
+      read_vector(ifs, data.flux_interp_stencil[dir]);
+    }
+    if (!ifs.good()) {
+      amrex::Abort("PeleC::readEBCache: truncated data in " + fname);
+    }
+  }
+
+  if (verbose > 0) {
+    amrex::Print() << "Level " << level << " EB2 structs read from " << name
+                   << std::endl;
+  }
+  return true;
+}
+
+amrex::Real*
+PeleC::getEBRedistScratch(const amrex::MFIter& mfi, const int ncomp)
+{
+  const int local_i = mfi.LocalIndex();
+  const int idx =
+    amrex::Gpu::inLaunchRegion() ? local_i : amrex::OpenMP::get_thread_num();
+  auto& scratch = sv_eb_redist_scratch[idx];
+  const std::size_t n = 2 * ncomp * sv_eb_bndry_geom[local_i].size();
+  if (scratch.size() < n) {
+    scratch.resize(n);
+  }
+  return scratch.data();
 }
 
 void
@@ -695,6 +1075,39 @@ initialize_EB2(
     // auto gshop = EB2::makeShop(pf);
     // EB2::Build(gshop, geom, max_level, max_level);
 
+  } else if (geom_type == "stl") {
+    amrex::ParmParse pp("stl");
+    std::string fname;
+    pp.get("file", fname);
+    amrex::Real scale = 1.0;
+    pp.query("scale", scale);
+    // Three coordinates, the missing ones being 0
+    StlPoint center = {0.0, 0.0, 0.0};
+    amrex::Vector<amrex::Real> center_in;
+    pp.queryarr("center", center_in);
+    if (center_in.size() > 3) {
+      amrex::Abort("stl.center must have at most 3 coordinates");
+    }
+    std::copy(center_in.begin(), center_in.end(), center.begin());
+    int fluid_inside = 0;
+    pp.query("fluid_inside", fluid_inside);
+
+    // Every rank builds the hierarchy and evaluates the function on its
+    // own boxes
+    amrex::Real t0 = amrex::ParallelDescriptor::second();
+    StlIF stl(fname, scale, center, fluid_inside != 0);
+    amrex::Real t_bvh = amrex::ParallelDescriptor::second() - t0;
+    t0 = amrex::ParallelDescriptor::second();
+    auto gshop = amrex::EB2::makeShop(stl);
+    amrex::EB2::Build(gshop, geom, max_coarsening_level, max_coarsening_level);
+    amrex::Real t_build = amrex::ParallelDescriptor::second() - t0;
+    amrex::ParallelDescriptor::ReduceRealMax(
+      t_bvh, amrex::ParallelDescriptor::IOProcessorNumber());
+    amrex::ParallelDescriptor::ReduceRealMax(
+      t_build, amrex::ParallelDescriptor::IOProcessorNumber());
+    amrex::Print() << "STL geometry " << fname << ", " << stl.numTriangles()
+                   << " triangles: hierarchy built in " << t_bvh
+                   << " s, EB2 in " << t_build << " s" << std::endl;
   } else if (geom_type == "moving_plane") {
     amrex::RealArray point;
     point[0] = 0.5;
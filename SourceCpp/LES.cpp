@@ -173,6 +173,180 @@ PeleC::getLESTerm(
   }
 }
 
+/**
+ * Number of ghost cells of the state needed by the LES model
+ **/
+int
+PeleC::getLESGrow() const
+{
+  int ngrow = 1;
+  if (les_model == 1) {
+    // See the note on the grow cells in getDynamicSmagorinskyLESTerm
+    const int nGrowD = 1;
+    const int nGrowC = les_coeff_filter.get_filter_ngrow();
+    const int nGrowT = les_test_filter.get_filter_ngrow();
+    ngrow = nGrowD + nGrowC + nGrowT + 1;
+  }
+#ifdef PELEC_USE_EB
+  if (eb_in_domain) {
+    ngrow += les_eb_ngrow;
+  }
+#endif
+  return ngrow;
+}
+
+#ifdef PELEC_USE_EB
+/**
+ * Divergence of the extensive LES fluxes on a single-valued cut-cell tile,
+ * following the EB treatment of the diffusion term. The fluxes are given on
+ * the faces of the tile grown by les_eb_ngrow, they are interpolated to the
+ * face centroids, then the hybrid divergence is redistributed. The SFS
+ * stresses and heat flux vanish at the walls so the cut faces carry no flux.
+ **/
+void
+PeleC::getLESEBDivergence(
+  const amrex::MFIter& mfi,
+  amrex::Real dt,
+  amrex::Real flux_factor,
+  amrex::FArrayBox (&flux_ec)[AMREX_SPACEDIM],
+  const amrex::Array4<amrex::Real>& Lterm)
+{
+  BL_PROFILE("PeleC::getLESEBDivergence()");
+  const amrex::Box vbox = mfi.tilebox();
+  const amrex::Box cbox = amrex::grow(vbox, les_eb_ngrow);
+  const amrex::Box ebfluxbox = amrex::grow(vbox, les_eb_ngrow - 1);
+  const amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> dx = geom.CellSizeArray();
+  amrex::Real dx1 = dx[0];
+  for (int dir = 1; dir < AMREX_SPACEDIM; ++dir) {
+    dx1 *= dx[dir];
+  }
+  const amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> dxD = {
+    D_DECL(dx1, dx1, dx1)};
+
+  auto const& fact = dynamic_cast<amrex::EBFArrayBoxFactory const&>(Factory());
+  auto const& flags = fact.getMultiEBCellFlagFab();
+
+  amrex::GpuArray<amrex::Array4<amrex::Real>, AMREX_SPACEDIM> flx;
+  for (int dir = 0; dir < AMREX_SPACEDIM; dir++) {
+    AMREX_ASSERT(flux_ec[dir].box().contains(
+      amrex::surroundingNodes(cbox, dir)));
+    flx[dir] = flux_ec[dir].array();
+  }
+
+  const int local_i = mfi.LocalIndex();
+  const int Ncut = sv_eb_bndry_geom[local_i].size();
+  auto* d_sv_eb_bndry_geom = (Ncut > 0 ? sv_eb_bndry_geom[local_i].data() : 0);
+
+  // SFS fluxes through the cut faces, all zero
+  SparseData<amrex::Real, EBBndrySten> eb_flux;
+  eb_flux.define(sv_eb_bndry_grad_stencil[local_i], NVAR);
+  eb_flux.setVal(0);
+  const int nFlux = eb_flux.numPts();
+
+  // Divergence of the face-centered fluxes, on the cut cells it is
+  // recomputed from the face centroid fluxes below
+  amrex::FArrayBox Dfab(cbox, NVAR);
+  amrex::Elixir Dfab_eli = Dfab.elixir();
+  auto const& Dterm = Dfab.array();
+  {
+    BL_PROFILE("PeleC::pc_flux_div()");
+    auto const& vol = volume.array(mfi);
+    amrex::ParallelFor(
+      cbox, NVAR, [=] AMREX_GPU_DEVICE(int i, int j, int k, int n) noexcept {
+        pc_flux_div(
+          i, j, k, n, AMREX_D_DECL(flx[0], flx[1], flx[2]), vol, Dterm);
+      });
+  }
+
+  {
+    BL_PROFILE("PeleC::pc_apply_face_stencil()");
+    for (int dir = 0; dir < AMREX_SPACEDIM; ++dir) {
+      int Nsten = flux_interp_stencil[dir][local_i].size();
+      const amrex::Box valid_interped_flux_box =
+        amrex::Box(ebfluxbox).surroundingNodes(dir);
+      pc_apply_face_stencil(
+        valid_interped_flux_box, stencil_volume_box,
+        flux_interp_stencil[dir][local_i].data(), Nsten, dir, NVAR, flx[dir]);
+    }
+  }
+
+  amrex::EBFluxRegister* fr_as_crse = nullptr;
+  if (do_reflux && level < parent->finestLevel()) {
+    fr_as_crse = &getFluxReg(level + 1);
+  }
+  amrex::EBFluxRegister* fr_as_fine = nullptr;
+  if (do_reflux && level > 0) {
+    fr_as_fine = &getFluxReg(level);
+  }
+
+  amrex::Real vol = 1;
+  for (int dir = 0; dir < AMREX_SPACEDIM; ++dir) {
+    vol *= geom.CellSize()[dir];
+  }
+  auto const& W = vfrac.array(mfi);
+
+  amrex::FArrayBox dm_as_fine(amrex::Box::TheUnitBox(), NVAR);
+  amrex::FArrayBox fab_drho_as_crse(amrex::Box::TheUnitBox(), NVAR);
+  amrex::IArrayBox fab_rrflag_as_crse(amrex::Box::TheUnitBox());
+  amrex::Elixir dm_as_fine_eli = dm_as_fine.elixir();
+  amrex::Elixir fab_drho_as_crse_eli = fab_drho_as_crse.elixir();
+  amrex::Elixir fab_rrflag_as_crse_eli = fab_rrflag_as_crse.elixir();
+  {
+    amrex::FArrayBox* p_drho_as_crse =
+      (fr_as_crse) ? fr_as_crse->getCrseData(mfi) : &fab_drho_as_crse;
+    const amrex::IArrayBox* p_rrflag_as_crse =
+      (fr_as_crse) ? fr_as_crse->getCrseFlag(mfi) : &fab_rrflag_as_crse;
+
+    if (fr_as_fine) {
+      dm_as_fine.resize(amrex::grow(vbox, 1), NVAR);
+      dm_as_fine_eli = dm_as_fine.elixir();
+      dm_as_fine.setVal<amrex::RunOn::Device>(0.0);
+    }
+    BL_PROFILE("PeleC::pc_fix_div_and_redistribute()");
+    pc_fix_div_and_redistribute(
+      vbox, vol, dt, NVAR, eb_small_vfrac, levmsk_notcovered,
+      d_sv_eb_bndry_geom, Ncut, flags.array(mfi),
+      AMREX_D_DECL(flx[0], flx[1], flx[2]), eb_flux.dataPtr(), nFlux,
+      vfrac.array(mfi), W, fr_as_crse != nullptr, fr_as_fine != nullptr,
+      level_mask.array(mfi), (*p_rrflag_as_crse).array(), Dterm,
+      (*p_drho_as_crse).array(), dm_as_fine.array(),
+      getEBRedistScratch(mfi, NVAR));
+  }
+  copy_array4(vbox, NVAR, Dterm, Lterm);
+
+#ifdef AMREX_USE_GPU
+  auto device = amrex::RunOn::Gpu;
+#else
+  auto device = amrex::RunOn::Cpu;
+#endif
+  if (do_reflux && flux_factor != 0) {
+    for (int dir = 0; dir < AMREX_SPACEDIM; dir++) {
+      flux_ec[dir].mult<amrex::RunOn::Device>(flux_factor);
+    }
+
+    if (fr_as_crse) {
+      fr_as_crse->CrseAdd(
+        mfi, {D_DECL(&flux_ec[0], &flux_ec[1], &flux_ec[2])}, dxD.data(), dt,
+        vfrac[mfi],
+        {D_DECL(
+          &((*areafrac[0])[mfi]), &((*areafrac[1])[mfi]),
+          &((*areafrac[2])[mfi]))},
+        device);
+    }
+
+    if (fr_as_fine) {
+      fr_as_fine->FineAdd(
+        mfi, {D_DECL(&flux_ec[0], &flux_ec[1], &flux_ec[2])}, dxD.data(), dt,
+        vfrac[mfi],
+        {D_DECL(
+          &((*areafrac[0])[mfi]), &((*areafrac[1])[mfi]),
+          &((*areafrac[2])[mfi]))},
+        dm_as_fine, device);
+    }
+  }
+}
+#endif
+
 /**
  * Calculate the LES term using the Smagorinsky SFS model
  **/
@@ -185,7 +359,8 @@ PeleC::getSmagorinskyLESTerm(
 {
   // Only use this functionality for 3D
 #if AMREX_SPACEDIM == 3
-  int ngrow = 1;
+  // One grow cell for the face gradients, plus those of the cut-cell tiles
+  const int ngrow = getLESGrow();
   const amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> dx = geom.CellSizeArray();
   amrex::Real dx1 = dx[0];
   for (int dir = 1; dir < AMREX_SPACEDIM; ++dir) {
@@ -195,8 +370,15 @@ PeleC::getSmagorinskyLESTerm(
     D_DECL(dx1, dx1, dx1)};
   const amrex::Real* dxDp = &(dxD[0]);
 
-  amrex::MultiFab S(grids, dmap, NVAR, ngrow);
-  FillPatch(*this, S, ngrow, time, State_Type, 0, NVAR); // FIXME: time+dt?
+  // The state and its primitives come from the level cache if enabled
+  const PrimCache* pcache = use_prim_cache ? &getPrimCache(time) : nullptr;
+  amrex::MultiFab Sfill;
+  if (pcache == nullptr) {
+    Sfill.define(grids, dmap, NVAR, ngrow);
+    // FIXME: time+dt?
+    FillPatch(*this, Sfill, ngrow, time, State_Type, 0, NVAR);
+  }
+  const amrex::MultiFab& S = (pcache != nullptr) ? pcache->state() : Sfill;
 
   // Fetch some gpu arrays
   prefetchToDevice(S);
@@ -214,37 +396,53 @@ PeleC::getSmagorinskyLESTerm(
   {
     for (amrex::MFIter mfi(S, amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi) {
       const amrex::Box vbox = mfi.tilebox();
-      const amrex::Box gbox = amrex::grow(vbox, ngrow);
-      const amrex::Box cbox = amrex::grow(vbox, ngrow - 1);
       const amrex::Box& dbox = geom.Domain();
 
+      // The fluxes of the tiles with cut cells within les_eb_ngrow are needed
+      // on les_eb_ngrow more cells for the redistribution
+      int nGrowE = 0;
 #ifdef PELEC_USE_EB
       const auto& flag_fab = flags[mfi];
-      amrex::FabType typ = flag_fab.getType(cbox);
-      if (typ != amrex::FabType::regular) {
-        amrex::Error("LES on a non-regular EB Fab is not available.");
-      }
+      amrex::FabType typ = flag_fab.getType(amrex::grow(vbox, les_eb_ngrow));
       if (typ == amrex::FabType::covered) {
         continue;
       }
+      if (typ == amrex::FabType::multivalued) {
+        amrex::Error("LES on a multi-valued EB Fab is not available.");
+      }
+      if (typ == amrex::FabType::singlevalued) {
+        nGrowE = les_eb_ngrow;
+      }
+      const int local_i = mfi.LocalIndex();
+      const int Ncut = sv_eb_bndry_geom[local_i].size();
+      auto* d_sv_eb_bndry_geom =
+        (Ncut > 0 ? sv_eb_bndry_geom[local_i].data() : 0);
 #endif
-
-      auto const& s = S.array(mfi);
-      int nqaux = NQAUX > 0 ? NQAUX : 1;
-      amrex::FArrayBox q(gbox, QVAR), qaux(gbox, nqaux);
-      amrex::Elixir qeli = q.elixir();
-      amrex::Elixir qauxeli = qaux.elixir();
-      auto const& q_ar = q.array();
-      auto const& qauxar = qaux.array();
+      const amrex::Box gbox = amrex::grow(vbox, nGrowE + 1);
+      const amrex::Box cbox = amrex::grow(vbox, nGrowE);
 
       // Get primitives, Q, including (Y, T, p, rho) from conserved state
       // required for L term
-      {
+      amrex::FArrayBox q, qaux;
+      amrex::Elixir qeli, qauxeli;
+      amrex::Array4<const amrex::Real> q_ar;
+      if (pcache != nullptr) {
+        q_ar = pcache->q().const_array(mfi);
+      } else {
+        auto const& s = S.array(mfi);
+        int nqaux = NQAUX > 0 ? NQAUX : 1;
+        q.resize(gbox, QVAR);
+        qaux.resize(gbox, nqaux);
+        qeli = q.elixir();
+        qauxeli = qaux.elixir();
+        auto const& qarr = q.array();
+        auto const& qauxar = qaux.array();
         BL_PROFILE("PeleC::ctoprim()");
         amrex::ParallelFor(
           gbox, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-            pc_ctoprim(i, j, k, s, q_ar, qauxar);
+            pc_ctoprim(i, j, k, s, qarr, qauxar);
           });
+        q_ar = q.const_array();
       }
 
       // Get the tangential derivatives
@@ -277,6 +475,14 @@ PeleC::getSmagorinskyLESTerm(
               pc_compute_tangential_vel_derivs(
                 i, j, k, q_ar, dir, d1, d2, tanders[dir]);
             });
+#ifdef PELEC_USE_EB
+          // Reset the derivatives using covered (invalid) data
+          if (typ == amrex::FabType::singlevalued && Ncut > 0) {
+            pc_compute_tangential_vel_derivs_eb(
+              eboxes[dir], dir, d1, d2, d_sv_eb_bndry_geom, Ncut, q_ar,
+              flags.array(mfi), tanders[dir]);
+          }
+#endif
         }
       }
 
@@ -312,6 +518,12 @@ PeleC::getSmagorinskyLESTerm(
       // Compute flux divergence (1/Vol).Div(F.A)
       auto const& Lterm = LESTerm.array(mfi);
       setV(vbox, NVAR, Lterm, 0.0);
+#ifdef PELEC_USE_EB
+      if (typ == amrex::FabType::singlevalued) {
+        getLESEBDivergence(mfi, dt, flux_factor, flux_ec, Lterm);
+        continue;
+      }
+#endif
       {
         BL_PROFILE("PeleC::pc_flux_div()");
         auto const& vol = volume.array(mfi);
@@ -328,7 +540,7 @@ PeleC::getSmagorinskyLESTerm(
 #else
       auto device = amrex::RunOn::Cpu;
 #endif
-      if (do_reflux && flux_factor != 0) // no eb in problem
+      if (do_reflux && flux_factor != 0) // regular tiles
       {
         for (int dir = 0; dir < AMREX_SPACEDIM; dir++) {
           amrex::ParallelFor(
@@ -386,18 +598,19 @@ PeleC::getDynamicSmagorinskyLESTerm(
     nGrowC = number of grow cells necessary for filtering the Smagorinsky coefficients
     nGrowT = number of grow cells necessary for filtering the derived quantities (test level)
 
+    On the tiles with cut or covered cells anywhere in the grown tile N is the tile grown by les_eb_ngrow, the
+    fluxes being redistributed, and the filters weight the cells with their volume fraction.
+
     ** Everything is calculated at cell centers (cc), then at the very end the coefficients and the stress terms (e.g. alpha_ij)
        are moved to edge/faces centers (ec) to calculate the fluxes. ec quantities have length N+1 in the face-normal 
        direction and length N in the other two directions.
 
   */
   // clang-format on
-  Filter test_filter = Filter(les_test_filter_type, les_test_filter_fgr);
-  Filter coeff_filter = Filter(box, 6);
-
+  // The test and coefficient filters are built once in init_filters
   const int nGrowD = 1;
-  const int nGrowC = coeff_filter.get_filter_ngrow();
-  const int nGrowT = test_filter.get_filter_ngrow();
+  const int nGrowC = les_coeff_filter.get_filter_ngrow();
+  const int nGrowT = les_test_filter.get_filter_ngrow();
 
   const amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> dx = geom.CellSizeArray();
   amrex::Real dx1 = dx[0];
@@ -408,11 +621,16 @@ PeleC::getDynamicSmagorinskyLESTerm(
     D_DECL(dx1, dx1, dx1)};
   const amrex::Real* dxDp = &(dxD[0]);
 
-  // 1. Get state variable data
-  amrex::MultiFab S(grids, dmap, NVAR, nGrowD + nGrowC + nGrowT + 1);
-  FillPatch(
-    *this, S, nGrowD + nGrowC + nGrowT + 1, time, State_Type, 0,
-    NVAR); // FIXME: time+dt?
+  // 1. Get state variable data, from the level cache if enabled
+  const PrimCache* pcache = use_prim_cache ? &getPrimCache(time) : nullptr;
+  amrex::MultiFab Sfill;
+  if (pcache == nullptr) {
+    Sfill.define(grids, dmap, NVAR, getLESGrow());
+    FillPatch(
+      *this, Sfill, getLESGrow(), time, State_Type, 0,
+      NVAR); // FIXME: time+dt?
+  }
+  const amrex::MultiFab& S = (pcache != nullptr) ? pcache->state() : Sfill;
   LES_Coeffs.setVal(0.0);
 
   // Fetch some gpu arrays
@@ -421,9 +639,7 @@ PeleC::getDynamicSmagorinskyLESTerm(
   prefetchToDevice(LES_Coeffs);
 
 #ifdef PELEC_USE_EB
-  auto const& fact =
-    dynamic_cast<amrex::EBFArrayBoxFactory const&>(S.Factory());
-  auto const& flags = fact.getMultiEBCellFlagFab();
+  const int nGrowL = getLESGrow();
 #endif
 
 #ifdef _OPENMP
@@ -432,41 +648,57 @@ PeleC::getDynamicSmagorinskyLESTerm(
   {
     for (amrex::MFIter mfi(S, amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi) {
       const amrex::Box vbox = mfi.tilebox();
-      const amrex::Box g0box = amrex::grow(vbox, nGrowD + nGrowC + nGrowT + 1);
-      const amrex::Box g1box = amrex::grow(vbox, nGrowC + nGrowT + 1);
-      const amrex::Box g2box = amrex::grow(vbox, nGrowD + nGrowC + 1);
-      const amrex::Box g3box = amrex::grow(vbox, nGrowC + 1);
-      const amrex::Box g4box = amrex::grow(vbox, 1);
-      const amrex::Box cbox = amrex::grow(vbox, 0);
       const amrex::Box& dbox = geom.Domain();
 
+      // The tiles with cut or covered cells anywhere the filters reach use
+      // the weighted filters, and the EB divergence on les_eb_ngrow more
+      // cells
+      int nGrowE = 0;
 #ifdef PELEC_USE_EB
-      const auto& flag_fab = flags[mfi];
-      amrex::FabType typ = flag_fab.getType(cbox);
-      if (typ != amrex::FabType::regular) {
-        amrex::Error("LES on a non-regular EB Fab is not available.");
+      amrex::FabType typ = amrex::FabType::regular;
+      if (eb_in_domain) {
+        typ = les_eb_flags[mfi].getType(amrex::grow(vbox, nGrowL));
       }
       if (typ == amrex::FabType::covered) {
         continue;
       }
+      if (typ == amrex::FabType::multivalued) {
+        amrex::Error("LES on a multi-valued EB Fab is not available.");
+      }
+      if (typ == amrex::FabType::singlevalued) {
+        nGrowE = les_eb_ngrow;
+      }
 #endif
-
-      auto const& s = S.array(mfi);
-      int nqaux = NQAUX > 0 ? NQAUX : 1;
-      amrex::FArrayBox q(g0box, QVAR), qaux(g0box, nqaux);
-      amrex::Elixir qeli = q.elixir();
-      amrex::Elixir qauxeli = qaux.elixir();
-      auto const& q_ar = q.array();
-      auto const& qauxar = qaux.array();
+      const amrex::Box g0box =
+        amrex::grow(vbox, nGrowE + nGrowD + nGrowC + nGrowT + 1);
+      const amrex::Box g1box = amrex::grow(vbox, nGrowE + nGrowC + nGrowT + 1);
+      const amrex::Box g2box = amrex::grow(vbox, nGrowE + nGrowD + nGrowC + 1);
+      const amrex::Box g3box = amrex::grow(vbox, nGrowE + nGrowC + 1);
+      const amrex::Box g4box = amrex::grow(vbox, nGrowE + 1);
+      const amrex::Box cbox = amrex::grow(vbox, nGrowE);
 
       // 1. Get primitives, Q, including (Y, T, p, rho) from conserved state
       // required for L term
-      {
+      amrex::FArrayBox q, qaux;
+      amrex::Elixir qeli, qauxeli;
+      amrex::Array4<const amrex::Real> q_ar;
+      if (pcache != nullptr) {
+        q_ar = pcache->q().const_array(mfi);
+      } else {
+        auto const& s = S.array(mfi);
+        int nqaux = NQAUX > 0 ? NQAUX : 1;
+        q.resize(g0box, QVAR);
+        qaux.resize(g0box, nqaux);
+        qeli = q.elixir();
+        qauxeli = qaux.elixir();
+        auto const& qarr = q.array();
+        auto const& qauxar = qaux.array();
         BL_PROFILE("PeleC::ctoprim()");
         amrex::ParallelFor(
           g0box, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-            pc_ctoprim(i, j, k, s, q_ar, qauxar);
+            pc_ctoprim(i, j, k, s, qarr, qauxar);
           });
+        q_ar = q.const_array();
       }
 
       // 2. Get dynamic Smagorinsky derived quantities after setting the
@@ -528,7 +760,17 @@ PeleC::getDynamicSmagorinskyLESTerm(
       auto const& filtered_Qaux_ar = filtered_Qaux.array();
 
       const amrex::FArrayBox& Sfab = S[mfi];
-      test_filter.apply_filter(g2box, Sfab, filtered_S);
+#ifdef PELEC_USE_EB
+      // The filters weight the cells with their volume fraction, so that the
+      // covered cells do not enter the filtered quantities
+      if (typ == amrex::FabType::singlevalued) {
+        les_test_filter.apply_weighted_filter(
+          g2box, {&Sfab}, {&filtered_S}, les_vfrac[mfi]);
+      } else
+#endif
+      {
+        les_test_filter.apply_filter(g2box, Sfab, filtered_S);
+      }
       {
         BL_PROFILE("PeleC::ctoprim()");
         amrex::ParallelFor(
@@ -536,11 +778,20 @@ PeleC::getDynamicSmagorinskyLESTerm(
             pc_ctoprim(i, j, k, filtered_S_ar, filtered_Q_ar, filtered_Qaux_ar);
           });
       }
-      test_filter.apply_filter(g3box, K, filtered_K);
-      test_filter.apply_filter(g3box, RUT, filtered_RUT);
-      test_filter.apply_filter(g3box, alphaij, filtered_alphaij);
-      test_filter.apply_filter(g3box, alpha, filtered_alpha);
-      test_filter.apply_filter(g3box, flux_T, filtered_flux_T);
+      const amrex::Vector<const amrex::FArrayBox*> derived{
+        &K, &RUT, &alphaij, &alpha, &flux_T};
+      const amrex::Vector<amrex::FArrayBox*> filtered_derived{
+        &filtered_K, &filtered_RUT, &filtered_alphaij, &filtered_alpha,
+        &filtered_flux_T};
+#ifdef PELEC_USE_EB
+      if (typ == amrex::FabType::singlevalued) {
+        les_test_filter.apply_weighted_filter(
+          g3box, derived, filtered_derived, les_vfrac[mfi]);
+      } else
+#endif
+      {
+        les_test_filter.apply_filter(g3box, derived, filtered_derived);
+      }
 
       // 4. Calculate the dynamic Smagorinsky coefficients - still at cell
       // centers
@@ -567,9 +818,25 @@ PeleC::getDynamicSmagorinskyLESTerm(
       }
 
       // 5. Filter to smooth the dynamic coefficients - still at cell
-      // centers
-      auto const& LES_Coeffs_ar = LES_Coeffs[mfi].array();
-      coeff_filter.apply_filter(g4box, coeff_cc, LES_Coeffs[mfi]);
+      // centers. The cut-cell tiles need them past the grow cell of
+      // LES_Coeffs, they are kept in a local FAB copied to LES_Coeffs.
+      amrex::Array4<amrex::Real> LES_Coeffs_ar = LES_Coeffs[mfi].array();
+#ifdef PELEC_USE_EB
+      amrex::FArrayBox filtered_coeff_cc;
+      amrex::Elixir filtered_coeff_cc_eli;
+      if (typ == amrex::FabType::singlevalued) {
+        filtered_coeff_cc.resize(g4box, nCompC);
+        filtered_coeff_cc_eli = filtered_coeff_cc.elixir();
+        les_coeff_filter.apply_weighted_filter(
+          g4box, {&coeff_cc}, {&filtered_coeff_cc}, les_vfrac[mfi]);
+        LES_Coeffs[mfi].copy<amrex::RunOn::Device>(
+          filtered_coeff_cc, amrex::grow(vbox, 1));
+        LES_Coeffs_ar = filtered_coeff_cc.array();
+      } else
+#endif
+      {
+        les_coeff_filter.apply_filter(g4box, coeff_cc, LES_Coeffs[mfi]);
+      }
 
       // 6. Get the SFS term
 
@@ -660,6 +927,12 @@ PeleC::getDynamicSmagorinskyLESTerm(
       // Compute flux divergence (1/Vol).Div(F.A)
       auto const& Lterm = LESTerm.array(mfi);
       setV(vbox, NVAR, Lterm, 0.0);
+#ifdef PELEC_USE_EB
+      if (typ == amrex::FabType::singlevalued) {
+        getLESEBDivergence(mfi, dt, flux_factor, flux_ec, Lterm);
+        continue;
+      }
+#endif
       {
         BL_PROFILE("PeleC::pc_flux_div()");
         auto const& vol = volume.array(mfi);
@@ -676,7 +949,7 @@ PeleC::getDynamicSmagorinskyLESTerm(
 #else
       auto device = amrex::RunOn::Cpu;
 #endif
-      if (do_reflux && flux_factor != 0) // no eb in problem
+      if (do_reflux && flux_factor != 0) // regular tiles
       {
         for (int dir = 0; dir < AMREX_SPACEDIM; dir++) {
           amrex::ParallelFor(
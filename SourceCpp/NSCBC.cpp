@@ -0,0 +1,157 @@
+#include "NSCBC.H"
+#include "PeleC.H"
+#include "prob.H"
+
+// The characteristic BCs are driven by an overload of bcnormal that also
+// returns the BC type, the relaxation parameters and the target values:
+//
+//   bcnormal(x, s_int, s_ext, idir, sgn, time, geomdata,
+//            bc_type, bc_params[6], bc_target[5])
+//
+// with x on the face along idir and s_int the conserved state of the last
+// interior cell.
+//
+// Problems that do not provide it fall back on this version, which leaves
+// the ghost cells to the regular fill.
+template <typename GeomData>
+AMREX_GPU_DEVICE AMREX_FORCE_INLINE void
+bcnormal(
+  const amrex::Real* /*x*/,
+  const amrex::Real* /*s_int*/,
+  amrex::Real* /*s_ext*/,
+  const int /*idir*/,
+  const int /*sgn*/,
+  const amrex::Real /*time*/,
+  GeomData const& /*geomdata*/,
+  int& bc_type,
+  amrex::Real* /*bc_params*/,
+  amrex::Real* /*bc_target*/)
+{
+  bc_type = 0; // Interior
+}
+
+bool
+pc_nscbc_needed(
+  const amrex::Box& qbx,
+  const amrex::Box& domain,
+  const int* bclo,
+  const int* bchi)
+{
+  for (int dir = 0; dir < AMREX_SPACEDIM; dir++) {
+    if (bclo[dir] == UserBC && qbx.smallEnd(dir) < domain.smallEnd(dir)) {
+      return true;
+    }
+    if (bchi[dir] == UserBC && qbx.bigEnd(dir) > domain.bigEnd(dir)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void
+pc_impose_NSCBC(
+  const amrex::Box& qbx,
+  amrex::Array4<amrex::Real> const& q,
+  amrex::Array4<amrex::Real> const& qaux,
+  const amrex::GpuArray<amrex::Array4<int>, AMREX_SPACEDIM>& bcMask,
+  const int* bclo,
+  const int* bchi,
+  const int* is_periodic,
+  const amrex::Geometry& geom,
+  const amrex::Real time)
+{
+  BL_PROFILE("PeleC::impose_NSCBC()");
+  const amrex::Box& domain = geom.Domain();
+  const amrex::GeometryData geomdata = geom.data();
+  const amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> dx =
+    geom.CellSizeArray();
+  const amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> prob_lo =
+    geom.ProbLoArray();
+  const amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> prob_hi =
+    geom.ProbHiArray();
+  const amrex::GpuArray<int, AMREX_SPACEDIM> domlo = {
+    AMREX_D_DECL(domain.smallEnd(0), domain.smallEnd(1), domain.smallEnd(2))};
+  const amrex::GpuArray<int, AMREX_SPACEDIM> domhi = {
+    AMREX_D_DECL(domain.bigEnd(0), domain.bigEnd(1), domain.bigEnd(2))};
+  const amrex::GpuArray<int, AMREX_SPACEDIM> perio = {
+    AMREX_D_DECL(is_periodic[0], is_periodic[1], is_periodic[2])};
+
+  // The faces are treated one after the other so that the ghost cells of an
+  // edge or a corner see the ones already updated by the previous faces
+  for (int dir = 0; dir < AMREX_SPACEDIM; dir++) {
+    for (int sgn = 1; sgn >= -1; sgn -= 2) {
+      const int bc = (sgn == 1) ? bclo[dir] : bchi[dir];
+      const int idx = (sgn == 1) ? domlo[dir] : domhi[dir];
+      if (
+        bc != UserBC ||
+        (sgn == 1 && qbx.smallEnd(dir) >= idx) ||
+        (sgn == -1 && qbx.bigEnd(dir) <= idx)) {
+        continue;
+      }
+
+      // Last interior cells along the face, leaving room for the central
+      // tangential derivatives
+      amrex::Box fbx(qbx);
+      fbx.setSmall(dir, idx);
+      fbx.setBig(dir, idx);
+      for (int t = 0; t < AMREX_SPACEDIM; t++) {
+        if (t != dir) {
+          fbx.grow(t, -1);
+        }
+      }
+
+      const int face_shift = (sgn == 1) ? 0 : 1;
+      const amrex::Real length = prob_hi[dir] - prob_lo[dir];
+      auto const& mask = bcMask[dir];
+      amrex::ParallelFor(
+        fbx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+          amrex::Real dd[3][5] = {{0.0}};
+          for (int t = 0; t < AMREX_SPACEDIM; t++) {
+            if (t == dir) {
+              nscbc_normal_derivative(i, j, k, dir, sgn, dx[dir], q, dd[dir]);
+            } else {
+              nscbc_tangential_derivative(
+                i, j, k, t, dx[t], domlo[t], domhi[t], perio[t], q, dd[t]);
+            }
+          }
+          amrex::Real T[5];
+          nscbc_transverse_terms(i, j, k, dir, dd, q, qaux, T);
+
+          // Target values and BC model from the problem, at the face and
+          // for the state of the last interior cell
+          amrex::Real x[AMREX_SPACEDIM] = {AMREX_D_DECL(
+            prob_lo[0] + (i + 0.5) * dx[0], prob_lo[1] + (j + 0.5) * dx[1],
+            prob_lo[2] + (k + 0.5) * dx[2])};
+          x[dir] = (sgn == 1) ? prob_lo[dir] : prob_hi[dir];
+          amrex::Real s_int[NVAR] = {0.0};
+          amrex::Real s_ext[NVAR] = {0.0};
+          nscbc_conserved_state(i, j, k, q, s_int);
+          int bc_type = 0;
+          amrex::Real bc_params[6] = {0.0};
+          amrex::Real bc_target[5] = {0.0};
+          bcnormal(
+            x, s_int, s_ext, dir, sgn, time, geomdata, bc_type, bc_params,
+            bc_target);
+          if (
+            bc_type != Inflow && bc_type != Outflow && bc_type != SlipWall &&
+            bc_type != NoSlipWall) {
+            return;
+          }
+
+          const int fi = i + face_shift * (dir == 0);
+          const int fj = j + face_shift * (dir == 1);
+          const int fk = k + face_shift * (dir == 2);
+          if (mask.contains(fi, fj, fk)) {
+            mask(fi, fj, fk) = bc_type;
+          }
+
+          amrex::Real L[5];
+          nscbc_compute_waves(
+            i, j, k, dir, sgn, bc_type, bc_params, bc_target, T, dd[dir],
+            length, q, qaux, L);
+          nscbc_update_ghost_cells(
+            i, j, k, dir, sgn, bc_type, dx[dir], L, q, qaux);
+        });
+    }
+  }
+}
@@ -2,6 +2,9 @@
 #include <omp.h>
 #endif
 
+#include <cmath>
+#include <type_traits>
+
 #include <AMReX_Vector.H>
 #include <AMReX_Utility.H>
 #include <AMReX_CONSTANTS.H>
@@ -10,6 +13,7 @@
 #include <AMReX_ParmParse.H>
 
 #ifdef PELEC_USE_EB
+#include <AMReX_EB2.H>
 #include <AMReX_EBMultiFabUtil.H>
 #endif
 
@@ -30,6 +34,7 @@ using namespace MASA;
 #include "Timestep.H"
 #include "Utilities.H"
 #include "Tagging.H"
+#include "Sampling.H"
 #include "IndexDefines.H"
 #ifdef USE_SUNDIALS_PP
 #include <reactor.h>
@@ -86,6 +91,12 @@ bool PeleC::body_state_set = false;
 amrex::GpuArray<amrex::Real, NVAR> PeleC::body_state;
 #endif
 
+#ifdef PELEC_USE_REACTIONS
+amrex::Vector<amrex::Vector<amrex::Real>> PeleC::react_pack_pool;
+#endif
+
+amrex::Vector<std::string> PeleC::sum_iq_vars;
+
 bool PeleC::do_react_load_balance = false;
 bool PeleC::do_mol_load_balance = false;
 
@@ -152,6 +163,9 @@ PeleC::read_params()
 
   pp.query("v", verbose);
   pp.query("sum_interval", sum_interval);
+  if (pp.contains("sum_iq_vars")) {
+    pp.getarr("sum_iq_vars", sum_iq_vars);
+  }
   pp.query("dump_old", dump_old);
 
   // Get boundary conditions
@@ -295,6 +309,14 @@ PeleC::read_params()
     }
   }
 
+  if (mol_weno_order != 0 && mol_weno_order != 5 && mol_weno_order != 7) {
+    amrex::Error("PeleC::mol_weno_order must be 0 (PLM), 5 or 7 (WENO-Z)");
+  }
+
+  if (io_aggregators_per_node < 0) {
+    amrex::Error("PeleC::io_aggregators_per_node must be non-negative");
+  }
+
   // for the moment, ppm_type = 0 does not support ppm_trace_sources --
   // we need to add the momentum sources to the states (and not
   // add it in trans_3d
@@ -337,11 +359,23 @@ PeleC::read_params()
   if (do_mol == 0) {
     amrex::Abort("Must do_mol = 1 when using EB\n");
   }
+  if (
+    eb_redistribution_type != "FluxRedist" &&
+    eb_redistribution_type != "StateRedist") {
+    amrex::Abort(
+      "PeleC::eb_redistribution_type must be FluxRedist or StateRedist");
+  }
+  if (eb_srd_target_vfrac <= 0.0 || eb_srd_target_vfrac > 1.0) {
+    amrex::Abort("PeleC::eb_srd_target_vfrac must be in (0, 1]");
+  }
 #endif
 
   // Read tagging parameters
   read_tagging_params();
 
+  // Read in-situ sampling parameters
+  read_sampling_params();
+
   // TODO: What is this?
   amrex::StateDescriptor::setBndryFuncThreadSafety(bndry_func_thread_safe);
 
@@ -352,6 +386,22 @@ PeleC::read_params()
   // whether to gather data
   ppa.query("loadbalance_with_workestimates", do_mol_load_balance);
   ppa.query("loadbalance_with_workestimates", do_react_load_balance);
+
+  if (use_reactions_work_estimate && !do_react_load_balance) {
+    amrex::Abort("use_reactions_work_estimate requires "
+                 "amr.loadbalance_with_workestimates = 1");
+  }
+
+#ifdef PELEC_USE_EB
+  // The state redistribution does not feed the flux registers
+  int max_level = 0;
+  ppa.query("max_level", max_level);
+  if (
+    eb_redistribution_type == "StateRedist" && max_level > 0 && do_reflux) {
+    amrex::Abort("PeleC::eb_redistribution_type = StateRedist requires "
+                 "amr.max_level = 0 or pelec.do_reflux = 0");
+  }
+#endif
 }
 
 PeleC::PeleC()
@@ -470,9 +520,9 @@ PeleC::PeleC(
 
   // initialize filters and variables
   nGrowF = 0;
-  if (use_explicit_filter) {
-    init_filters();
-  }
+  init_filters();
+
+  init_hydro_scratch();
 }
 
 PeleC::~PeleC() {}
@@ -791,19 +841,8 @@ PeleC::estTimeStep(amrex::Real dt_old)
 
   const amrex::MultiFab& stateMF = get_new_data(State_Type);
 
-  const amrex::Real* dx = geom.CellSize();
-
   std::string limiter = "pelec.max_dt";
 
-  // Start the hydro with the max_dt value, but divide by CFL
-  // to account for the fact that we multiply by it at the end.
-  // This ensures that if max_dt is more restrictive than the hydro
-  // criterion, we will get exactly max_dt for a timestep.
-
-  amrex::Real estdt_hydro = max_dt / cfl;
-  amrex::Real estdt_vdif = max_dt / cfl;
-  amrex::Real estdt_tdif = max_dt / cfl;
-  amrex::Real estdt_edif = max_dt / cfl;
   if (do_hydro || do_mol || diffuse_vel || diffuse_temp || diffuse_enth) {
 
 #ifdef PELEC_USE_EB
@@ -813,118 +852,83 @@ PeleC::estTimeStep(amrex::Real dt_old)
 #endif
 
     prefetchToDevice(stateMF); // This should accelerate the below operations.
-    amrex::Real AMREX_D_DECL(dx1 = dx[0], dx2 = dx[1], dx3 = dx[2]);
-
-    if (do_hydro) {
-      amrex::Real dt = amrex::ReduceMin(
-        stateMF,
-#ifdef PELEC_USE_EB
-        flags,
-#endif
-        0,
-        [=] AMREX_GPU_HOST_DEVICE(
-          amrex::Box const& bx, const amrex::Array4<const amrex::Real>& fab_arr
-#ifdef PELEC_USE_EB
-          ,
-          const amrex::Array4<const amrex::EBCellFlag>& flag_arr
-#endif
-          ) noexcept -> amrex::Real {
-          return pc_estdt_hydro(
-            bx, fab_arr,
-#ifdef PELEC_USE_EB
-            flag_arr,
-#endif
-            AMREX_D_DECL(dx1, dx2, dx3));
-        });
-      estdt_hydro = amrex::min(estdt_hydro, dt);
-    }
+    const amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> dxa =
+      geom.CellSizeArray();
+    const amrex::GpuArray<int, TimeStep::num_limiters> active = {
+      do_hydro, diffuse_vel, diffuse_temp, diffuse_enth};
+
+    // All the limits come out of one sweep over the state, so that the
+    // transport coefficients are evaluated once per cell
+    amrex::ReduceOps<
+      amrex::ReduceOpMin, amrex::ReduceOpMin, amrex::ReduceOpMin,
+      amrex::ReduceOpMin>
+      reduce_op;
+    amrex::ReduceData<amrex::Real, amrex::Real, amrex::Real, amrex::Real>
+      reduce_data(reduce_op);
+    using ReduceTuple = typename decltype(reduce_data)::Type;
 
-    if (diffuse_vel) {
-      amrex::Real dt = amrex::ReduceMin(
-        stateMF,
-#ifdef PELEC_USE_EB
-        flags,
-#endif
-        0,
-        [=] AMREX_GPU_HOST_DEVICE(
-          amrex::Box const& bx, const amrex::Array4<const amrex::Real>& fab_arr
-#ifdef PELEC_USE_EB
-          ,
-          const amrex::Array4<const amrex::EBCellFlag>& flag_arr
-#endif
-          ) noexcept -> amrex::Real {
-          return pc_estdt_veldif(
-            bx, fab_arr,
-#ifdef PELEC_USE_EB
-            flag_arr,
-#endif
-            AMREX_D_DECL(dx1, dx2, dx3));
-        });
-      estdt_vdif = amrex::min(estdt_vdif, dt);
-    }
-
-    if (diffuse_temp) {
-      amrex::Real dt = amrex::ReduceMin(
-        stateMF,
-#ifdef PELEC_USE_EB
-        flags,
+#ifdef _OPENMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
 #endif
-        0,
-        [=] AMREX_GPU_HOST_DEVICE(
-          amrex::Box const& bx, const amrex::Array4<const amrex::Real>& fab_arr
+    for (amrex::MFIter mfi(stateMF, amrex::TilingIfNotGPU()); mfi.isValid();
+         ++mfi) {
+      const amrex::Box& bx = mfi.tilebox();
+      auto const& sarr = stateMF.const_array(mfi);
 #ifdef PELEC_USE_EB
-          ,
-          const amrex::Array4<const amrex::EBCellFlag>& flag_arr
+      auto const& flag_arr = flags.const_array(mfi);
 #endif
-          ) noexcept -> amrex::Real {
-          return pc_estdt_tempdif(
-            bx, fab_arr,
+      reduce_op.eval(
+        bx, reduce_data,
+        [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept -> ReduceTuple {
+          amrex::Real dt[TimeStep::num_limiters];
 #ifdef PELEC_USE_EB
-            flag_arr,
+          if (flag_arr(i, j, k).isCovered()) {
+            return {
+              TimeStep::max_dt, TimeStep::max_dt, TimeStep::max_dt,
+              TimeStep::max_dt};
+          }
 #endif
-            AMREX_D_DECL(dx1, dx2, dx3));
+          pc_estdt(i, j, k, sarr, active, dxa, dt);
+          return {dt[0], dt[1], dt[2], dt[3]};
         });
-      estdt_tdif = amrex::min(estdt_tdif, dt);
     }
 
-    if (diffuse_enth) {
-      amrex::Real dt = amrex::ReduceMin(
-        stateMF,
-#ifdef PELEC_USE_EB
-        flags,
-#endif
-        0,
-        [=] AMREX_GPU_HOST_DEVICE(
-          amrex::Box const& bx, const amrex::Array4<const amrex::Real>& fab_arr
-#ifdef PELEC_USE_EB
-          ,
-          const amrex::Array4<const amrex::EBCellFlag>& flag_arr
-#endif
-          ) noexcept -> amrex::Real {
-          return pc_estdt_enthdif(
-            bx, fab_arr,
-#ifdef PELEC_USE_EB
-            flag_arr,
-#endif
-            AMREX_D_DECL(dx1, dx2, dx3));
-        });
-      estdt_edif = amrex::min(estdt_edif, dt);
+    // Start the limits with the max_dt value, but divide by CFL
+    // to account for the fact that we multiply by it at the end.
+    // This ensures that if max_dt is more restrictive than the hydro
+    // criterion, we will get exactly max_dt for a timestep.
+    ReduceTuple hv = reduce_data.value();
+    amrex::Real estdt_lim[TimeStep::num_limiters] = {
+      amrex::min(max_dt / cfl, amrex::get<TimeStep::hydro>(hv)),
+      amrex::min(max_dt / cfl, amrex::get<TimeStep::veldif>(hv)),
+      amrex::min(max_dt / cfl, amrex::get<TimeStep::tempdif>(hv)),
+      amrex::min(max_dt / cfl, amrex::get<TimeStep::enthdif>(hv))};
+    amrex::ParallelDescriptor::ReduceRealMin(
+      estdt_lim, TimeStep::num_limiters);
+
+    int binding = TimeStep::hydro;
+    for (int n = 0; n < TimeStep::num_limiters; n++) {
+      estdt_lim[n] *= cfl;
+      if (estdt_lim[n] < estdt_lim[binding]) {
+        binding = n;
+      }
     }
-
-    estdt_hydro = amrex::min(
-      estdt_hydro, amrex::min(estdt_vdif, amrex::min(estdt_tdif, estdt_edif)));
-
-    amrex::ParallelDescriptor::ReduceRealMin(estdt_hydro);
-    estdt_hydro *= cfl;
+    const amrex::Real estdt_hydro = estdt_lim[binding];
 
     if (verbose) {
       amrex::Print() << "...estimated hydro-limited timestep at level " << level
                      << ": " << estdt_hydro << std::endl;
+      for (int n = 0; n < TimeStep::num_limiters; n++) {
+        if (active[n]) {
+          amrex::Print() << "...   " << TimeStep::limiter_names[n]
+                         << " limit: " << estdt_lim[n] << std::endl;
+        }
+      }
     }
 
     // Determine if this is more restrictive than the maximum timestep limiting
     if (estdt_hydro < estdt) {
-      limiter = "hydro";
+      limiter = TimeStep::limiter_names[binding];
       estdt = estdt_hydro;
     }
   }
@@ -1143,6 +1147,10 @@ PeleC::post_timestep(int iteration)
     if (sum_int_test || sum_per_test) {
       sum_integrated_quantities();
     }
+
+    if (sampling_due(nstep, cumtime, dtlev)) {
+      sample_solution(false);
+    }
   }
 }
 
@@ -1175,9 +1183,9 @@ PeleC::post_restart()
 
   // initialize filters and variables
   nGrowF = 0;
-  if (use_explicit_filter) {
-    init_filters();
-  }
+  init_filters();
+
+  init_hydro_scratch();
 
 #ifdef DO_PROBLEM_POST_RESTART
   problem_post_restart();
@@ -1197,6 +1205,17 @@ PeleC::post_regrid(int lbase, int new_finest)
   BL_PROFILE("PeleC::post_regrid()");
   fine_mask.clear();
 
+  // Amr built the distribution of the new grids from the work estimate
+  if (load_balance_verbosity > 0 && do_react_load_balance && level > lbase) {
+    const amrex::Real imb_plain =
+      load_imbalance(amrex::DistributionMapping(grids));
+    const amrex::Real imb = load_imbalance(dmap);
+    amrex::Print() << "Level " << level
+                   << " load imbalance (max/mean work per rank): "
+                   << imb_plain << " without work estimates, " << imb
+                   << " with work estimates" << std::endl;
+  }
+
 #ifdef AMREX_PARTICLES
   if (do_spray_particles && theSprayPC() != 0 && level == lbase) {
     // TODO: Determine how many ghost cells to use here
@@ -1206,6 +1225,33 @@ PeleC::post_regrid(int lbase, int new_finest)
 #endif
 }
 
+amrex::Real
+PeleC::load_imbalance(const amrex::DistributionMapping& dm)
+{
+  BL_PROFILE("PeleC::load_imbalance()");
+
+  const amrex::MultiFab& cost = get_new_data(Work_Estimate_Type);
+  amrex::Vector<amrex::Real> box_cost(grids.size(), 0.0);
+  for (amrex::MFIter mfi(cost); mfi.isValid(); ++mfi) {
+    box_cost[mfi.index()] =
+      cost[mfi].sum<amrex::RunOn::Device>(mfi.validbox(), 0);
+  }
+  amrex::ParallelDescriptor::ReduceRealSum(
+    box_cost.data(), static_cast<int>(box_cost.size()));
+
+  const int nprocs = amrex::ParallelDescriptor::NProcs();
+  amrex::Vector<amrex::Real> rank_cost(nprocs, 0.0);
+  amrex::Real total = 0.0;
+  for (int i = 0; i < box_cost.size(); ++i) {
+    rank_cost[dm[i]] += box_cost[i];
+    total += box_cost[i];
+  }
+
+  const amrex::Real max_cost =
+    *std::max_element(rank_cost.begin(), rank_cost.end());
+  return total > 0.0 ? max_cost * nprocs / total : 1.0;
+}
+
 void
 PeleC::post_init(amrex::Real stop_time)
 {
@@ -1269,6 +1315,10 @@ PeleC::post_init(amrex::Real stop_time)
   if (sum_int_test || sum_per_test) {
     sum_integrated_quantities();
   }
+
+  if (sampling_due(nstep, cumtime, dtlev)) {
+    sample_solution(true);
+  }
 }
 
 int
@@ -1540,228 +1590,251 @@ PeleC::errorEst(
 {
   BL_PROFILE("PeleC::errorEst()");
 
+  // Criteria active on this level
+  TaggingCriteria crit;
+  const int set_criteria = TaggingParm::set_criteria;
+  auto activate = [&](const int c, const int max_lev) {
+    if (((set_criteria >> c) & 1) != 0 && level < max_lev) {
+      crit.active |= 1 << c;
+    }
+  };
+  activate(tag_denerr, TaggingParm::max_denerr_lev);
+  activate(tag_dengrad, TaggingParm::max_dengrad_lev);
+  activate(tag_presserr, TaggingParm::max_presserr_lev);
+  activate(tag_pressgrad, TaggingParm::max_pressgrad_lev);
+  activate(tag_velerr, TaggingParm::max_velerr_lev);
+  activate(tag_velgrad, TaggingParm::max_velgrad_lev);
+  activate(tag_vorterr, TaggingParm::max_vorterr_lev);
+  activate(tag_temperr, TaggingParm::max_temperr_lev);
+  activate(tag_tempgrad, TaggingParm::max_tempgrad_lev);
+  if (!flame_trac_name.empty()) {
+    for (int i = 0; i < spec_names.size(); ++i) {
+      if (flame_trac_name == spec_names[i]) {
+        crit.ftrac_idx = i;
+      }
+    }
+    if (crit.ftrac_idx < 0) {
+      amrex::Abort("Unknown species identified as flame_trac_name");
+    }
+    activate(tag_ftracerr, TaggingParm::max_ftracerr_lev);
+    activate(tag_ftracgrad, TaggingParm::max_ftracgrad_lev);
+  }
+#ifdef PELEC_USE_EB
+  activate(tag_vfracerr, TaggingParm::max_vfracerr_lev);
+#endif
+  crit.denerr = TaggingParm::denerr;
+  crit.dengrad = TaggingParm::dengrad;
+  crit.presserr = TaggingParm::presserr;
+  crit.pressgrad = TaggingParm::pressgrad;
+  crit.velerr = TaggingParm::velerr;
+  crit.velgrad = TaggingParm::velgrad;
+  crit.vorterr = TaggingParm::vorterr * std::pow(2.0, level);
+  crit.temperr = TaggingParm::temperr;
+  crit.tempgrad = TaggingParm::tempgrad;
+  crit.ftracerr = TaggingParm::ftracerr;
+  crit.ftracgrad = TaggingParm::ftracgrad;
+
+  // The problem tags may use any component of the state
+  const bool problem_tags =
+    !std::is_same<ProblemTags, EmptyProbTagStruct>::value;
+  if (crit.active == 0 && !problem_tags) {
+    return;
+  }
+
+  // Components and ghost cells the active criteria need
+  amrex::Vector<int> needed(NVAR, problem_tags ? 1 : 0);
+  auto need = [&](const int comp, const int ncomp) {
+    for (int n = comp; n < comp + ncomp; n++) {
+      needed[n] = 1;
+    }
+  };
+  if (crit.on(tag_denerr) || crit.on(tag_dengrad)) {
+    need(URHO, 1);
+  }
+  if (crit.on(tag_presserr) || crit.on(tag_pressgrad)) {
+    need(URHO, 1);
+    need(UTEMP, 1);
+    need(UFS, NUM_SPECIES);
+  }
+  if (crit.on(tag_velerr) || crit.on(tag_velgrad) || crit.on(tag_vorterr)) {
+    need(URHO, 1);
+    need(UMX, 3);
+  }
+  if (crit.on(tag_temperr) || crit.on(tag_tempgrad)) {
+    need(UTEMP, 1);
+  }
+  if (crit.on(tag_ftracerr) || crit.on(tag_ftracgrad)) {
+    need(URHO, 1);
+    need(UFS + crit.ftrac_idx, 1);
+  }
+  const int stencil_criteria = (1 << tag_dengrad) | (1 << tag_pressgrad) |
+                               (1 << tag_velgrad) | (1 << tag_vorterr) |
+                               (1 << tag_tempgrad) | (1 << tag_ftracgrad);
+  const int ng = (problem_tags || (crit.active & stencil_criteria) != 0)
+                   ? 1
+                   : 0;
+
+  // Filled by runs of consecutive needed components
   amrex::MultiFab S_data(
     get_new_data(State_Type).boxArray(),
-    get_new_data(State_Type).DistributionMap(), NVAR, 1);
+    get_new_data(State_Type).DistributionMap(), NVAR, ng);
   const amrex::Real cur_time = state[State_Type].curTime();
-  FillPatch(
-    *this, S_data, S_data.nGrow(), cur_time, State_Type, Density, NVAR, 0);
+  for (int n = 0; n < NVAR;) {
+    if (needed[n] == 0) {
+      n++;
+      continue;
+    }
+    int m = n;
+    while (m < NVAR && needed[m] != 0) {
+      m++;
+    }
+    FillPatch(*this, S_data, ng, cur_time, State_Type, n, m - n, n);
+    n = m;
+  }
 
-  amrex::Vector<amrex::BCRec> bcs(NVAR);
   const char tagval = amrex::TagBox::SET;
-  const char clearval = amrex::TagBox::CLEAR;
+  const amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> dx = geom.CellSizeArray();
+  const amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> prob_lo =
+    geom.ProbLoArray();
+  const auto captured_level = level;
 
 #ifdef _OPENMP
 #pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
 #endif
-  {
-    for (amrex::MFIter mfi(S_data, amrex::TilingIfNotGPU()); mfi.isValid();
-         ++mfi) {
-      const amrex::Box& tilebox = mfi.tilebox();
-      const auto Sfab = S_data.array(mfi);
-      auto tag_arr = tags.array(mfi);
-      const auto datbox = S_data[mfi].box();
-      amrex::Elixir S_data_mfi_eli = S_data[mfi].elixir();
-
+  for (amrex::MFIter mfi(S_data, amrex::TilingIfNotGPU()); mfi.isValid();
+       ++mfi) {
+    const amrex::Box& tilebox = mfi.tilebox();
+    const auto Sfab = S_data.const_array(mfi);
+    auto tag_arr = tags.array(mfi);
+    amrex::Elixir S_data_mfi_eli = S_data[mfi].elixir();
 #ifdef PELEC_USE_EB
-      const auto vfrac_arr = vfrac.array(mfi);
-#endif
-
-      amrex::FArrayBox S_derData(datbox, 1);
-      amrex::Elixir S_derData_eli = S_derData.elixir();
-      auto S_derarr = S_derData.array();
-      const int ncp = S_derData.nComp();
-      const int* bc = bcs[0].data();
-
-      // Tagging density
-      if (level < TaggingParm::max_denerr_lev) {
-        amrex::ParallelFor(
-          tilebox, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-            tag_error(i, j, k, tag_arr, Sfab, TaggingParm::denerr, tagval);
-          });
-      }
-      if (level < TaggingParm::max_dengrad_lev) {
-        amrex::ParallelFor(
-          tilebox, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-            tag_graderror(i, j, k, tag_arr, Sfab, TaggingParm::dengrad, tagval);
-          });
-      }
-
-      // Tagging pressure
-      S_derData.setVal<amrex::RunOn::Device>(0.0);
-      pc_derpres(
-        datbox, S_derData, ncp, Sfab.nComp(), S_data[mfi], geom, time, bc,
-        level);
-      if (level < TaggingParm::max_presserr_lev) {
-        amrex::ParallelFor(
-          tilebox, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-            tag_error(
-              i, j, k, tag_arr, S_derarr, TaggingParm::presserr, tagval);
-          });
-      }
-      if (level < TaggingParm::max_pressgrad_lev) {
-        amrex::ParallelFor(
-          tilebox, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-            tag_graderror(
-              i, j, k, tag_arr, S_derarr, TaggingParm::pressgrad, tagval);
-          });
-      }
-
-      // Tagging vel_x
-      S_derData.setVal<amrex::RunOn::Device>(0.0);
-      pc_dervelx(
-        datbox, S_derData, ncp, Sfab.nComp(), S_data[mfi], geom, time, bc,
-        level);
-      if (level < TaggingParm::max_velerr_lev) {
-        amrex::ParallelFor(
-          tilebox, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-            tag_error(i, j, k, tag_arr, S_derarr, TaggingParm::velerr, tagval);
-          });
-      }
-      if (level < TaggingParm::max_velgrad_lev) {
-        amrex::ParallelFor(
-          tilebox, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-            tag_graderror(
-              i, j, k, tag_arr, S_derarr, TaggingParm::velgrad, tagval);
-          });
-      }
-
-      // Tagging vel_y
-      S_derData.setVal<amrex::RunOn::Device>(0.0);
-      pc_dervely(
-        datbox, S_derData, ncp, Sfab.nComp(), S_data[mfi], geom, time, bc,
-        level);
-      if (level < TaggingParm::max_velerr_lev) {
-        amrex::ParallelFor(
-          tilebox, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-            tag_error(i, j, k, tag_arr, S_derarr, TaggingParm::velerr, tagval);
-          });
-      }
-      if (level < TaggingParm::max_velgrad_lev) {
-        amrex::ParallelFor(
-          tilebox, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-            tag_graderror(
-              i, j, k, tag_arr, S_derarr, TaggingParm::velgrad, tagval);
-          });
-      }
-
-      // Tagging vel_z
-      S_derData.setVal<amrex::RunOn::Device>(0.0);
-      pc_dervelz(
-        datbox, S_derData, ncp, Sfab.nComp(), S_data[mfi], geom, time, bc,
-        level);
-      if (level < TaggingParm::max_velerr_lev) {
-        amrex::ParallelFor(
-          tilebox, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-            tag_error(i, j, k, tag_arr, S_derarr, TaggingParm::velerr, tagval);
-          });
-      }
-      if (level < TaggingParm::max_velgrad_lev) {
-        amrex::ParallelFor(
-          tilebox, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-            tag_graderror(
-              i, j, k, tag_arr, S_derarr, TaggingParm::velgrad, tagval);
-          });
-      }
+    const auto vfrac_arr = vfrac.const_array(mfi);
+#endif
+
+    // Pressure of the tile and of the grow cells its jumps reach, evaluated
+    // once per cell rather than at each neighbour
+    amrex::FArrayBox pfab;
+    amrex::Elixir pfab_eli;
+    amrex::Array4<const amrex::Real> p_arr;
+    if (crit.on(tag_presserr) || crit.on(tag_pressgrad)) {
+      const amrex::Box pbox = amrex::grow(tilebox, ng);
+      pfab.resize(pbox, 1);
+      pfab_eli = pfab.elixir();
+      auto const& pf = pfab.array();
+      amrex::ParallelFor(
+        pbox, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+          const amrex::Real r = Sfab(i, j, k, URHO);
+          const amrex::Real rhoInv = 1.0 / r;
+          amrex::Real T = Sfab(i, j, k, UTEMP);
+          amrex::Real p, massfrac[NUM_SPECIES];
+          for (int n = 0; n < NUM_SPECIES; ++n) {
+            massfrac[n] = Sfab(i, j, k, UFS + n) * rhoInv;
+          }
+          EOS::RTY2P(r, T, massfrac, p);
+          pf(i, j, k) = p;
+        });
+      p_arr = pfab.const_array();
+    }
 
-      // Tagging magnitude of vorticity
-      S_derData.setVal<amrex::RunOn::Device>(0.0);
-      pc_dermagvort(
-        tilebox, S_derData, ncp, Sfab.nComp(), S_data[mfi], geom, time, bc,
-        level);
-      if (level < TaggingParm::max_vorterr_lev) {
-        const amrex::Real vorterr = TaggingParm::vorterr * std::pow(2.0, level);
-        amrex::ParallelFor(
-          tilebox, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-            tag_abserror(i, j, k, tag_arr, S_derarr, vorterr, tagval);
-          });
-      }
+    // All the criteria of a cell in one pass, the derived quantities being
+    // computed where the criteria need them
+    amrex::ParallelFor(
+      tilebox, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+        bool tag = false;
+
+        if (crit.on(tag_denerr) || crit.on(tag_dengrad)) {
+          auto rho = [=](int ii, int jj, int kk) {
+            return Sfab(ii, jj, kk, URHO);
+          };
+          const amrex::Real c = rho(i, j, k);
+          tag = tag || (crit.on(tag_denerr) && c >= crit.denerr);
+          tag = tag || (crit.on(tag_dengrad) &&
+                        max_jump(i, j, k, c, rho) >= crit.dengrad);
+        }
 
-      // Tagging temperature
-      S_derData.setVal<amrex::RunOn::Device>(0.0);
-      pc_dertemp(
-        datbox, S_derData, ncp, Sfab.nComp(), S_data[mfi], geom, time, bc,
-        level);
-      if (level < TaggingParm::max_temperr_lev) {
-        amrex::ParallelFor(
-          tilebox, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-            tag_error(i, j, k, tag_arr, S_derarr, TaggingParm::temperr, tagval);
-          });
-      }
-      if (level < TaggingParm::max_tempgrad_lev) {
-        amrex::ParallelFor(
-          tilebox, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-            tag_graderror(
-              i, j, k, tag_arr, S_derarr, TaggingParm::tempgrad, tagval);
-          });
-      }
+        if (crit.on(tag_presserr) || crit.on(tag_pressgrad)) {
+          auto pres = [=](int ii, int jj, int kk) {
+            return p_arr(ii, jj, kk);
+          };
+          const amrex::Real c = pres(i, j, k);
+          tag = tag || (crit.on(tag_presserr) && c >= crit.presserr);
+          tag = tag || (crit.on(tag_pressgrad) &&
+                        max_jump(i, j, k, c, pres) >= crit.pressgrad);
+        }
 
-      // Tagging flame tracer
-      if (!flame_trac_name.empty()) {
-        int idx = -1;
-        for (int i = 0; i < spec_names.size(); ++i) {
-          if (flame_trac_name == spec_names[i]) {
-            idx = i;
+        if (crit.on(tag_velerr) || crit.on(tag_velgrad)) {
+          for (int dir = 0; dir < 3; dir++) {
+            auto vel = [=](int ii, int jj, int kk) {
+              return Sfab(ii, jj, kk, UMX + dir) / Sfab(ii, jj, kk, URHO);
+            };
+            const amrex::Real c = vel(i, j, k);
+            tag = tag || (crit.on(tag_velerr) && c >= crit.velerr);
+            tag = tag || (crit.on(tag_velgrad) &&
+                          max_jump(i, j, k, c, vel) >= crit.velgrad);
           }
         }
 
-        if (idx >= 0) {
-          // const std::string name = "Y("+flame_trac_name+")";
-          // if (amrex::ParallelDescriptor::IOProcessor())
-          //  amrex::Print() << " Flame tracer will be " << name << '\n';
-
-          S_derData.setVal<amrex::RunOn::Device>(0.0);
-          pc_derspectrac(
-            datbox, S_derData, ncp, Sfab.nComp(), S_data[mfi], geom, time, bc,
-            level, idx);
-
-          if (level < TaggingParm::max_ftracerr_lev) {
-            amrex::ParallelFor(
-              tilebox, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-                tag_error(
-                  i, j, k, tag_arr, S_derarr, TaggingParm::ftracerr, tagval);
-              });
-          }
-          if (level < TaggingParm::max_ftracgrad_lev) {
-            amrex::ParallelFor(
-              tilebox, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-                tag_graderror(
-                  i, j, k, tag_arr, S_derarr, TaggingParm::ftracgrad, tagval);
-              });
-          }
+        if (crit.on(tag_vorterr)) {
+          auto vel = [=](int ii, int jj, int kk, int dir) {
+            return Sfab(ii, jj, kk, UMX + dir) / Sfab(ii, jj, kk, URHO);
+          };
+          amrex::Real vort2 = 0.0;
+#if AMREX_SPACEDIM > 1
+          const amrex::Real vx =
+            0.5 * (vel(i + 1, j, k, 1) - vel(i - 1, j, k, 1)) / dx[0];
+          const amrex::Real uy =
+            0.5 * (vel(i, j + 1, k, 0) - vel(i, j - 1, k, 0)) / dx[1];
+          vort2 += (vx - uy) * (vx - uy);
+#endif
+#if AMREX_SPACEDIM > 2
+          const amrex::Real wx =
+            0.5 * (vel(i + 1, j, k, 2) - vel(i - 1, j, k, 2)) / dx[0];
+          const amrex::Real wy =
+            0.5 * (vel(i, j + 1, k, 2) - vel(i, j - 1, k, 2)) / dx[1];
+          const amrex::Real uz =
+            0.5 * (vel(i, j, k + 1, 0) - vel(i, j, k - 1, 0)) / dx[2];
+          const amrex::Real vz =
+            0.5 * (vel(i, j, k + 1, 1) - vel(i, j, k - 1, 1)) / dx[2];
+          vort2 += (wy - vz) * (wy - vz) + (uz - wx) * (uz - wx);
+#endif
+          tag = tag || (std::sqrt(vort2) >= crit.vorterr);
+        }
 
-        } else {
-          amrex::Abort("Unknown species identified as flame_trac_name");
+        if (crit.on(tag_temperr) || crit.on(tag_tempgrad)) {
+          auto temp = [=](int ii, int jj, int kk) {
+            return Sfab(ii, jj, kk, UTEMP);
+          };
+          const amrex::Real c = temp(i, j, k);
+          tag = tag || (crit.on(tag_temperr) && c >= crit.temperr);
+          tag = tag || (crit.on(tag_tempgrad) &&
+                        max_jump(i, j, k, c, temp) >= crit.tempgrad);
+        }
+
+        if (crit.on(tag_ftracerr) || crit.on(tag_ftracgrad)) {
+          const int nf = UFS + crit.ftrac_idx;
+          auto ftrac = [=](int ii, int jj, int kk) {
+            return Sfab(ii, jj, kk, nf) / Sfab(ii, jj, kk, URHO);
+          };
+          const amrex::Real c = ftrac(i, j, k);
+          tag = tag || (crit.on(tag_ftracerr) && c >= crit.ftracerr);
+          tag = tag || (crit.on(tag_ftracgrad) &&
+                        max_jump(i, j, k, c, ftrac) >= crit.ftracgrad);
         }
-      }
 
 #ifdef PELEC_USE_EB
-      // Tagging volume fraction
-      if (level < TaggingParm::max_vfracerr_lev) {
-        amrex::ParallelFor(
-          tilebox, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-            tag_error_bounds(i, j, k, tag_arr, vfrac_arr, 0.0, 1.0, tagval);
-          });
-      }
+        if (crit.on(tag_vfracerr)) {
+          tag = tag || (0.0 < vfrac_arr(i, j, k) && vfrac_arr(i, j, k) < 1.0);
+        }
 #endif
 
-      // Problem specific tagging
-      const amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> dx =
-        geom.CellSizeArray();
-      const amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> prob_lo =
-        geom.ProbLoArray();
-      const auto captured_level = level;
-      amrex::ParallelFor(
-        tilebox, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-          set_problem_tags<ProblemTags>(
-            i, j, k, tag_arr, Sfab, tagval, dx, prob_lo, time, captured_level);
-        });
+        if (tag) {
+          tag_arr(i, j, k) = tagval;
+        }
 
-      // Now update the tags in the TagBox.
-      // tag_arr.tags(itags, tilebox);
-      // rho_eli.clear();
-      // temp_eli.clear();
-    }
+        // Problem specific tagging
+        set_problem_tags<ProblemTags>(
+          i, j, k, tag_arr, Sfab, tagval, dx, prob_lo, time, captured_level);
+      });
   }
 }
 
@@ -1837,15 +1910,27 @@ PeleC::init_reactor()
 {
 #ifdef USE_SUNDIALS_PP
   int reactor_type = 1;
-  int ode_ncells = 1;
 #ifndef USE_CUDA_SUNDIALS_PP
+  int ode_ncells = amrex::max(1, chem_ncells);
+  int nthreads = 1;
+#ifdef _OPENMP
+  nthreads = omp_get_max_threads();
+#endif
+  react_pack_pool.resize(nthreads);
 #ifdef _OPENMP
 #pragma omp parallel
 #endif
   {
     reactor_init(&reactor_type, &ode_ncells);
+    int tid = 0;
+#ifdef _OPENMP
+    tid = omp_get_thread_num();
+#endif
+    // rY, rY_src, re and re_src for ode_ncells cells
+    react_pack_pool[tid].resize(ode_ncells * (2 * NUM_SPECIES + 3));
   }
 #else
+  int ode_ncells = 1;
   reactor_info(&reactor_type, &ode_ncells);
 #endif
 #endif
@@ -1854,6 +1939,7 @@ PeleC::init_reactor()
 void
 PeleC::close_reactor()
 {
+  react_pack_pool.clear();
 }
 #endif
 
@@ -1891,6 +1977,33 @@ PeleC::init_les()
 void
 PeleC::init_filters()
 {
+  // Filters of the dynamic Smagorinsky model, built once per level so that
+  // their weights stay on the device
+  if (do_les && les_model == 1) {
+    les_test_filter = Filter(les_test_filter_type, les_test_filter_fgr);
+    les_coeff_filter = Filter(box, 6);
+
+#ifdef PELEC_USE_EB
+    // The filters of the tiles near the EB reach past the grow cells of the
+    // factory data, the flags and volume fractions are taken from the EB2
+    // level over all the cells they reach
+    if (eb_in_domain) {
+      const int ngrow = getLESGrow();
+      const auto& eb_level =
+        dynamic_cast<amrex::EBFArrayBoxFactory const&>(Factory())
+          .getEBLevel();
+      les_eb_flags.define(grids, dmap, 1, ngrow + 1);
+      eb_level.fillEBCellFlag(les_eb_flags, geom);
+      les_vfrac.define(grids, dmap, 1, ngrow);
+      eb_level.fillVolFrac(les_vfrac, geom);
+    }
+#endif
+  }
+
+  if (!use_explicit_filter) {
+    return;
+  }
+
   if (level > 0) {
     amrex::IntVect ref_ratio = parent->refRatio(level - 1);
     les_filter =
@@ -2030,6 +2143,49 @@ PeleC::computeTemp(amrex::MultiFab& S, int ng)
   }
 }
 
+int
+PeleC::primCacheGrow() const
+{
+  int ng = Sborder.nGrow();
+  if (do_les) {
+    ng = amrex::max(ng, getLESGrow());
+  }
+  return ng;
+}
+
+const PrimCache&
+PeleC::getPrimCache(amrex::Real time)
+{
+  const int ng = primCacheGrow();
+  if (!prim_cache.isDefined() || prim_cache.nGrow() != ng) {
+    prim_cache.define(grids, dmap, Factory(), ng, do_mol || do_diffuse);
+  }
+  if (!prim_cache.isValid(time)) {
+    FillPatch(*this, prim_cache.state(), ng, time, State_Type, 0, NVAR);
+    prim_cache.fill(time);
+  }
+  return prim_cache;
+}
+
+void
+PeleC::invalidatePrimCache()
+{
+  prim_cache.invalidate();
+  Sborder_from_cache = false;
+}
+
+void
+PeleC::fillSborder(amrex::Real time, int ng)
+{
+  if (use_prim_cache) {
+    const PrimCache& pc = getPrimCache(time);
+    amrex::MultiFab::Copy(Sborder, pc.state(), 0, 0, NVAR, ng);
+    Sborder_from_cache = true;
+  } else {
+    FillPatch(*this, Sborder, ng, time, State_Type, 0, NVAR);
+  }
+}
+
 amrex::Real
 PeleC::getCPUTime()
 {
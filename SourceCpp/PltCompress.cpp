@@ -0,0 +1,417 @@
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_Print.H>
+#include <AMReX_VisMF.H>
+
+#include "PltCompress.H"
+
+namespace pltcompress {
+
+namespace {
+
+const char* const codec_names[num_codec_types] = {
+  "raw", "float32", "lossless", "quantized"};
+
+const std::string header_version = "PeleC compressed MultiFab 1";
+
+// PackBits run-length coding: a control byte h < 128 is followed by h + 1
+// literal bytes, h >= 128 by one byte repeated h - 126 times
+void
+packbits(const unsigned char* b, const std::size_t n, std::vector<char>& out)
+{
+  std::size_t i = 0;
+  while (i < n) {
+    std::size_t run = 1;
+    while (i + run < n && run < 129 && b[i + run] == b[i]) {
+      run++;
+    }
+    if (run >= 2) {
+      out.push_back(static_cast<char>(run + 126));
+      out.push_back(static_cast<char>(b[i]));
+      i += run;
+      continue;
+    }
+    const std::size_t start = i++;
+    while (i < n && i - start < 128 && !(i + 1 < n && b[i] == b[i + 1])) {
+      i++;
+    }
+    out.push_back(static_cast<char>(i - start - 1));
+    out.insert(out.end(), b + start, b + i);
+  }
+}
+
+void
+unpackbits(
+  const char* in,
+  const std::size_t nbytes,
+  unsigned char* b,
+  const std::size_t n)
+{
+  std::size_t pos = 0;
+  std::size_t i = 0;
+  while (i < n) {
+    if (pos >= nbytes) {
+      amrex::Abort("pltcompress: truncated run-length data");
+    }
+    const unsigned int h = static_cast<unsigned char>(in[pos++]);
+    if (h < 128) {
+      const std::size_t len = h + 1;
+      if (pos + len > nbytes || i + len > n) {
+        amrex::Abort("pltcompress: corrupt run-length data");
+      }
+      std::memcpy(b + i, in + pos, len);
+      pos += len;
+      i += len;
+    } else {
+      const std::size_t len = h - 126;
+      if (pos >= nbytes || i + len > n) {
+        amrex::Abort("pltcompress: corrupt run-length data");
+      }
+      std::memset(b + i, static_cast<unsigned char>(in[pos++]), len);
+      i += len;
+    }
+  }
+}
+
+// Byte planes of the w byte words: plane p holds byte p of every word
+void
+shuffle_pack(
+  const unsigned char* words,
+  const std::size_t nwords,
+  const int w,
+  std::vector<char>& out)
+{
+  std::vector<unsigned char> planes(nwords * w);
+  for (std::size_t i = 0; i < nwords; i++) {
+    for (int p = 0; p < w; p++) {
+      planes[p * nwords + i] = words[i * w + p];
+    }
+  }
+  packbits(planes.data(), planes.size(), out);
+}
+
+void
+unpack_unshuffle(
+  const char* in,
+  const std::size_t nbytes,
+  unsigned char* words,
+  const std::size_t nwords,
+  const int w)
+{
+  std::vector<unsigned char> planes(nwords * w);
+  unpackbits(in, nbytes, planes.data(), planes.size());
+  for (std::size_t i = 0; i < nwords; i++) {
+    for (int p = 0; p < w; p++) {
+      words[i * w + p] = planes[p * nwords + i];
+    }
+  }
+}
+
+template <class T>
+void
+append(std::vector<char>& out, const T& val)
+{
+  const char* p = reinterpret_cast<const char*>(&val);
+  out.insert(out.end(), p, p + sizeof(T));
+}
+
+template <class T>
+T
+extract(const char* in, const std::size_t nbytes, std::size_t& pos)
+{
+  if (pos + sizeof(T) > nbytes) {
+    amrex::Abort("pltcompress: truncated data");
+  }
+  T val;
+  std::memcpy(&val, in + pos, sizeof(T));
+  pos += sizeof(T);
+  return val;
+}
+
+std::string
+data_file_name(const std::string& name, const int rank)
+{
+  char buf[16];
+  std::snprintf(buf, sizeof(buf), "%05d", rank);
+  return name + "_Z_D_" + buf;
+}
+
+} // namespace
+
+std::string
+codec_name(const int codec)
+{
+  AMREX_ALWAYS_ASSERT(codec >= 0 && codec < num_codec_types);
+  return codec_names[codec];
+}
+
+int
+codec_from_name(const std::string& name)
+{
+  for (int c = 0; c < num_codec_types; c++) {
+    if (name == codec_names[c]) {
+      return c;
+    }
+  }
+  return -1;
+}
+
+void
+encode(
+  const amrex::Real* v,
+  const std::size_t n,
+  const int codec,
+  const amrex::Real tol,
+  std::vector<char>& out)
+{
+  int c = codec;
+
+  // Integer multiples of the step, as zigzag coded deltas
+  std::vector<std::uint64_t> deltas;
+  const amrex::Real step = 2.0 * tol;
+  if (c == quantized) {
+    AMREX_ALWAYS_ASSERT(tol > 0.0);
+    const amrex::Real kmax = 9007199254740992.0; // 2^53
+    deltas.resize(n);
+    std::int64_t kprev = 0;
+    for (std::size_t i = 0; i < n; i++) {
+      const amrex::Real q = v[i] / step;
+      if (!(std::abs(q) < kmax)) {
+        c = lossless;
+        break;
+      }
+      const std::int64_t k = std::llround(q);
+      const std::int64_t d = k - kprev;
+      deltas[i] = (static_cast<std::uint64_t>(d) << 1) ^
+                  static_cast<std::uint64_t>(d >> 63);
+      kprev = k;
+    }
+  }
+
+  out.push_back(static_cast<char>(c));
+  switch (c) {
+  case raw:
+    out.insert(
+      out.end(), reinterpret_cast<const char*>(v),
+      reinterpret_cast<const char*>(v + n));
+    break;
+  case float32:
+    for (std::size_t i = 0; i < n; i++) {
+      append(out, static_cast<float>(v[i]));
+    }
+    break;
+  case lossless:
+    shuffle_pack(
+      reinterpret_cast<const unsigned char*>(v), n, sizeof(amrex::Real), out);
+    break;
+  case quantized:
+    append(out, step);
+    shuffle_pack(
+      reinterpret_cast<const unsigned char*>(deltas.data()), n,
+      sizeof(std::uint64_t), out);
+    break;
+  default:
+    amrex::Abort("pltcompress: unknown codec");
+  }
+}
+
+void
+decode(
+  const char* in, const std::size_t nbytes, const std::size_t n, amrex::Real* v)
+{
+  std::size_t pos = 0;
+  const int c = extract<char>(in, nbytes, pos);
+  switch (c) {
+  case raw:
+    if (pos + n * sizeof(amrex::Real) > nbytes) {
+      amrex::Abort("pltcompress: truncated raw data");
+    }
+    std::memcpy(v, in + pos, n * sizeof(amrex::Real));
+    break;
+  case float32:
+    for (std::size_t i = 0; i < n; i++) {
+      v[i] = extract<float>(in, nbytes, pos);
+    }
+    break;
+  case lossless:
+    unpack_unshuffle(
+      in + pos, nbytes - pos, reinterpret_cast<unsigned char*>(v), n,
+      sizeof(amrex::Real));
+    break;
+  case quantized: {
+    const amrex::Real step = extract<amrex::Real>(in, nbytes, pos);
+    std::vector<std::uint64_t> deltas(n);
+    unpack_unshuffle(
+      in + pos, nbytes - pos, reinterpret_cast<unsigned char*>(deltas.data()),
+      n, sizeof(std::uint64_t));
+    std::int64_t k = 0;
+    for (std::size_t i = 0; i < n; i++) {
+      const std::int64_t d =
+        static_cast<std::int64_t>(deltas[i] >> 1) ^
+        -static_cast<std::int64_t>(deltas[i] & 1);
+      k += d;
+      v[i] = static_cast<amrex::Real>(k) * step;
+    }
+    break;
+  }
+  default:
+    amrex::Abort("pltcompress: unknown codec in data");
+  }
+}
+
+void
+write_multifab(
+  const amrex::MultiFab& mf,
+  const std::string& name,
+  const amrex::Vector<int>& codecs,
+  const amrex::Vector<amrex::Real>& tols)
+{
+  BL_PROFILE("pltcompress::write_multifab()");
+  const int ncomp = mf.nComp();
+  const int nfabs = mf.size();
+  AMREX_ALWAYS_ASSERT(codecs.size() == ncomp && tols.size() == ncomp);
+
+  // Blocks of the local FABs, each component preceded by its size
+  std::vector<char> buf;
+  amrex::Vector<long> offsets(nfabs, 0);
+  for (amrex::MFIter mfi(mf); mfi.isValid(); ++mfi) {
+    const amrex::Box& bx = mfi.validbox();
+    const std::size_t npts = bx.numPts();
+    amrex::FArrayBox hfab(bx, ncomp, amrex::The_Pinned_Arena());
+    hfab.copy<amrex::RunOn::Gpu>(mf[mfi], bx);
+    amrex::Gpu::streamSynchronize();
+    offsets[mfi.index()] = buf.size();
+    for (int n = 0; n < ncomp; n++) {
+      std::vector<char> enc;
+      encode(hfab.dataPtr(n), npts, codecs[n], tols[n], enc);
+      append(buf, static_cast<std::uint64_t>(enc.size()));
+      buf.insert(buf.end(), enc.begin(), enc.end());
+    }
+  }
+  if (!buf.empty()) {
+    const std::string fname =
+      data_file_name(name, amrex::ParallelDescriptor::MyProc());
+    std::ofstream ofs(fname.c_str(), std::ios::out | std::ios::binary);
+    if (!ofs.good()) {
+      amrex::FileOpenFailed(fname);
+    }
+    ofs.write(buf.data(), buf.size());
+  }
+
+  amrex::ParallelDescriptor::ReduceLongSum(
+    offsets.dataPtr(), nfabs, amrex::ParallelDescriptor::IOProcessorNumber());
+  if (amrex::ParallelDescriptor::IOProcessor()) {
+    const std::string hname = name + "_Z_H";
+    std::ofstream ofs(hname.c_str());
+    if (!ofs.good()) {
+      amrex::FileOpenFailed(hname);
+    }
+    ofs << header_version << '\n' << ncomp << '\n';
+    ofs << std::setprecision(17);
+    for (int n = 0; n < ncomp; n++) {
+      ofs << codec_name(codecs[n]) << ' ' << tols[n] << '\n';
+    }
+    ofs << nfabs << '\n';
+    for (int i = 0; i < nfabs; i++) {
+      ofs << mf.DistributionMap()[i] << ' ' << offsets[i] << '\n';
+    }
+    mf.boxArray().writeOn(ofs);
+    ofs << '\n';
+  }
+  amrex::ParallelDescriptor::Barrier();
+}
+
+void
+read_multifab(amrex::MultiFab& mf, const std::string& name)
+{
+  BL_PROFILE("pltcompress::read_multifab()");
+  amrex::Vector<char> hbuf;
+  amrex::ParallelDescriptor::ReadAndBcastFile(name + "_Z_H", hbuf);
+  std::istringstream is(std::string(hbuf.dataPtr()), std::istringstream::in);
+
+  std::string version;
+  std::getline(is, version);
+  if (version != header_version) {
+    amrex::Abort("pltcompress: unknown header in " + name + "_Z_H");
+  }
+  int ncomp = 0;
+  is >> ncomp;
+  for (int n = 0; n < ncomp; n++) {
+    std::string cname;
+    amrex::Real tol;
+    is >> cname >> tol;
+  }
+  int nfabs = 0;
+  is >> nfabs;
+  amrex::Vector<int> owner(nfabs);
+  amrex::Vector<long> offsets(nfabs);
+  for (int i = 0; i < nfabs; i++) {
+    is >> owner[i] >> offsets[i];
+  }
+  amrex::BoxArray ba;
+  ba.readFrom(is);
+  AMREX_ALWAYS_ASSERT(static_cast<int>(ba.size()) == nfabs);
+
+  amrex::DistributionMapping dm(ba);
+  mf.define(ba, dm, ncomp, 0);
+  for (amrex::MFIter mfi(mf); mfi.isValid(); ++mfi) {
+    const int i = mfi.index();
+    const amrex::Box& bx = mfi.validbox();
+    const std::size_t npts = bx.numPts();
+    const std::string fname = data_file_name(name, owner[i]);
+    std::ifstream ifs(fname.c_str(), std::ios::in | std::ios::binary);
+    if (!ifs.good()) {
+      amrex::FileOpenFailed(fname);
+    }
+    ifs.seekg(offsets[i]);
+    amrex::FArrayBox hfab(bx, ncomp, amrex::The_Pinned_Arena());
+    for (int n = 0; n < ncomp; n++) {
+      std::uint64_t nbytes = 0;
+      ifs.read(reinterpret_cast<char*>(&nbytes), sizeof(nbytes));
+      std::vector<char> enc(nbytes);
+      ifs.read(enc.data(), nbytes);
+      if (!ifs.good()) {
+        amrex::Abort("pltcompress: truncated data in " + fname);
+      }
+      decode(enc.data(), enc.size(), npts, hfab.dataPtr(n));
+    }
+    mf[mfi].copy<amrex::RunOn::Gpu>(hfab, bx);
+    amrex::Gpu::streamSynchronize();
+  }
+}
+
+void
+decompress_plotfile(const std::string& dir)
+{
+  for (int lev = 0;; lev++) {
+    const std::string name = dir + "/Level_" + std::to_string(lev) + "/Cell";
+    int found = 0;
+    if (amrex::ParallelDescriptor::IOProcessor()) {
+      std::ifstream ifs((name + "_Z_H").c_str());
+      found = ifs.good() ? 1 : 0;
+    }
+    amrex::ParallelDescriptor::Bcast(
+      &found, 1, amrex::ParallelDescriptor::IOProcessorNumber());
+    if (found == 0) {
+      if (lev == 0) {
+        amrex::Abort("pltcompress: no compressed data in " + dir);
+      }
+      break;
+    }
+    amrex::MultiFab mf;
+    read_multifab(mf, name);
+    amrex::VisMF::Write(mf, name);
+    if (amrex::ParallelDescriptor::IOProcessor()) {
+      amrex::Print() << "Decompressed " << name << std::endl;
+    }
+  }
+}
+
+} // namespace pltcompress
@@ -0,0 +1,82 @@
+#include "PrimCache.H"
+#include "IndexDefines.H"
+#include "Utilities.H"
+#include "Transport.H"
+
+void
+PrimCache::define(
+  const amrex::BoxArray& ba,
+  const amrex::DistributionMapping& dm,
+  const amrex::FabFactory<amrex::FArrayBox>& factory,
+  int ng,
+  bool with_coeffs)
+{
+  const int nqaux = NQAUX > 0 ? NQAUX : 1;
+  m_state.define(ba, dm, NVAR, ng, amrex::MFInfo(), factory);
+  m_q.define(ba, dm, QVAR, ng, amrex::MFInfo(), factory);
+  m_qaux.define(ba, dm, nqaux, ng, amrex::MFInfo(), factory);
+  m_with_coeffs = with_coeffs;
+  if (m_with_coeffs) {
+    m_coeffs.define(ba, dm, dComp_lambda + 1, ng, amrex::MFInfo(), factory);
+  } else {
+    m_coeffs.clear();
+  }
+  m_valid = false;
+}
+
+void
+PrimCache::fill(amrex::Real time)
+{
+  BL_PROFILE("PrimCache::fill()");
+  AMREX_ASSERT(isDefined());
+
+#ifdef _OPENMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
+  for (amrex::MFIter mfi(m_state, amrex::TilingIfNotGPU()); mfi.isValid();
+       ++mfi) {
+    // Covered cells hold the body state and are converted as well, the
+    // operators read them through the stencils of the cut cells
+    const amrex::Box gbox = mfi.growntilebox();
+
+    auto const& s = m_state.const_array(mfi);
+    auto const& qar = m_q.array(mfi);
+    auto const& qauxar = m_qaux.array(mfi);
+    {
+      BL_PROFILE("PeleC::ctoprim()");
+      amrex::ParallelFor(
+        gbox, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+          pc_ctoprim(i, j, k, s, qar, qauxar);
+        });
+    }
+
+    if (m_with_coeffs) {
+      auto const& qar_yin = m_q[mfi].array(QFS);
+      auto const& qar_Tin = m_q[mfi].array(QTEMP);
+      auto const& qar_rhoin = m_q[mfi].array(QRHO);
+      auto const& coe_rhoD = m_coeffs[mfi].array(dComp_rhoD);
+      auto const& coe_mu = m_coeffs[mfi].array(dComp_mu);
+      auto const& coe_xi = m_coeffs[mfi].array(dComp_xi);
+      auto const& coe_lambda = m_coeffs[mfi].array(dComp_lambda);
+      BL_PROFILE("PeleC::get_transport_coeffs()");
+      amrex::launch(gbox, [=] AMREX_GPU_DEVICE(amrex::Box const& tbx) {
+        get_transport_coeffs(
+          tbx, qar_yin, qar_Tin, qar_rhoin, coe_rhoD, coe_mu, coe_xi,
+          coe_lambda);
+      });
+    }
+  }
+
+  m_time = time;
+  m_valid = true;
+}
+
+bool
+PrimCache::isValid(amrex::Real time) const
+{
+  // The stage times are recomputed the same way by every caller, so this
+  // only guards against round-off
+  return m_valid &&
+         std::abs(time - m_time) <=
+           1.0e-12 * amrex::max<amrex::Real>(1.0, std::abs(m_time));
+}
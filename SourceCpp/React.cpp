@@ -1,4 +1,7 @@
+#include <algorithm>
+
 #include <AMReX_DistributionMapping.H>
+#include <AMReX_BoxIterator.H>
 
 #include "PeleC.H"
 #include "React.H"
@@ -68,236 +71,100 @@ PeleC::react_state(
   amrex::MultiFab& reactions = get_new_data(Reactions_Type);
   reactions.setVal(0.0);
   prefetchToDevice(reactions);
-  if (use_reactions_work_estimate) {
-    amrex::Abort("Need to implement redistribution of chemistry work");
-  }
 
-#ifdef PELEC_USE_EB
-  auto const& fact =
-    dynamic_cast<amrex::EBFArrayBoxFactory const&>(S_new.Factory());
-  auto const& flags = fact.getMultiEBCellFlagFab();
-#endif
+  // Chemistry cost per cell in integrator work, or in seconds when
+  // use_reactions_work_estimate is set
+  const bool wall_cost = (use_reactions_work_estimate != 0);
 
-#ifdef _OPENMP
-#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
-#endif
-  {
-    for (amrex::MFIter mfi(S_new, amrex::TilingIfNotGPU()); mfi.isValid();
-         ++mfi) {
-
-      const amrex::Box& bx = mfi.growntilebox(ng);
-
-      auto const& uold =
-        react_init ? S_new.array(mfi) : get_old_data(State_Type).array(mfi);
-      auto const& unew = S_new.array(mfi);
-      auto const& a = Ap->array(mfi);
-      amrex::FArrayBox w(bx, 1);
-      amrex::Elixir w_eli = w.elixir();
-      auto const& w_arr = w.array();
-      auto const& I_R = reactions.array(mfi);
-      const int do_update =
-        react_init ? 0 : 1; // TODO: Update here? Or just get reaction source?
+  amrex::Real chem_time = amrex::ParallelDescriptor::second();
 
+  if (chem_redistribute) {
+    react_state_redistributed(dt, react_init, *Ap, chem_time);
+  } else {
 #ifdef PELEC_USE_EB
-      const auto& flag_fab = flags[mfi];
-      amrex::FabType typ = flag_fab.getType(bx);
-      if (typ == amrex::FabType::covered) {
-        continue;
-      } else if (
-        typ == amrex::FabType::singlevalued || typ == amrex::FabType::regular)
+    auto const& fact =
+      dynamic_cast<amrex::EBFArrayBoxFactory const&>(S_new.Factory());
+    auto const& flags = fact.getMultiEBCellFlagFab();
 #endif
-      {
-        if (chem_integrator == 1) {
-          const int nsubsteps_min = adaptrk_nsubsteps_min;
-          const int nsubsteps_max = adaptrk_nsubsteps_max;
-          const int nsubsteps_guess = adaptrk_nsubsteps_guess;
-          const amrex::Real errtol = adaptrk_errtol;
-
-          amrex::ParallelFor(
-            bx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-              pc_expl_reactions(
-                i, j, k, uold, unew, a, w_arr, I_R, dt, nsubsteps_min,
-                nsubsteps_max, nsubsteps_guess, errtol, do_update);
-            });
-        } else if (chem_integrator == 2) {
-#ifdef USE_SUNDIALS_PP
-          const auto len = amrex::length(bx);
-          const auto lo = amrex::lbound(bx);
-          const int ncells = len.x * len.y * len.z;
-          int reactor_type = 1;
-          amrex::Real fabcost;
-          amrex::Real current_time = 0.0;
-
-          amrex::Real* rY_in;
-          amrex::Real* rY_src_in;
-          amrex::Real* re_in;
-          amrex::Real* re_src_in;
-
-#ifdef USE_CUDA_SUNDIALS_PP
-          cudaError_t cuda_status = cudaSuccess;
-          cudaMallocManaged(
-            &rY_in, (NUM_SPECIES + 1) * ncells * sizeof(amrex::Real));
-          cudaMallocManaged(
-            &rY_src_in, NUM_SPECIES * ncells * sizeof(amrex::Real));
-          cudaMallocManaged(&re_in, ncells * sizeof(amrex::Real));
-          cudaMallocManaged(&re_src_in, ncells * sizeof(amrex::Real));
-
-          int ode_ncells = ncells;
-#else
-          rY_in = new amrex::Real[ncells * (NUM_SPECIES + 1)];
-          rY_src_in = new amrex::Real[ncells * (NUM_SPECIES)];
-          re_in = new amrex::Real[ncells];
-          re_src_in = new amrex::Real[ncells];
-
-          int ode_ncells = 1;
-#endif
-          amrex::ParallelFor(
-            bx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-              amrex::Real rhou = uold(i, j, k, UMX);
-              amrex::Real rhov = uold(i, j, k, UMY);
-              amrex::Real rhow = uold(i, j, k, UMZ);
-              amrex::Real rho_old = uold(i, j, k, URHO);
-              amrex::Real rhoInv = 1.0 / rho_old;
-              amrex::Real rho = 0.;
-
-              for (int nsp = UFS; nsp < (UFS + NUM_SPECIES); nsp++) {
-                rho += uold(i, j, k, nsp);
-              }
 
-              amrex::Real nrg =
-                (uold(i, j, k, UEDEN) -
-                 (0.5 * (rhou * rhou + rhov * rhov + rhow * rhow) * rhoInv)) *
-                rhoInv;
-
-              rhou = unew(i, j, k, UMX);
-              rhov = unew(i, j, k, UMY);
-              rhow = unew(i, j, k, UMZ);
-              rhoInv = 1.0 / unew(i, j, k, URHO);
-
-              amrex::Real rhoedot_ext =
-                ((unew(i, j, k, UEDEN) -
-                  (0.5 * (rhou * rhou + rhov * rhov + rhow * rhow) * rhoInv)) -
-                 rho * nrg) /
-                dt;
-
-              int offset =
-                (k - lo.z) * len.x * len.y + (j - lo.y) * len.x + (i - lo.x);
-              for (int nsp = 0; nsp < NUM_SPECIES; nsp++) {
-                rY_in[offset * (NUM_SPECIES + 1) + nsp] =
-                  uold(i, j, k, UFS + nsp);
-                rY_src_in[offset * NUM_SPECIES + nsp] = a(i, j, k, UFS + nsp);
-              }
-              rY_in[offset * (NUM_SPECIES + 1) + NUM_SPECIES] =
-                uold(i, j, k, UTEMP);
-              re_in[offset] = uold(i, j, k, UEINT);
-              re_src_in[offset] = rhoedot_ext;
-            });
+    // Sundials on the CPU spreads the cells of each box over the threads,
+    // so the boxes are visited by a single thread and are not tiled
+    const bool cvode_batched = cvode_threads_cells();
+    const amrex::MFItInfo mfi_info =
+      cvode_batched ? amrex::MFItInfo() : amrex::TilingIfNotGPU();
 
-#ifdef USE_CUDA_SUNDIALS_PP
-          cuda_status = cudaStreamSynchronize(amrex::Gpu::gpuStream());
+#ifdef _OPENMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion() && !cvode_batched)
 #endif
-          fabcost = 0.0;
-          for (int i = 0; i < ncells; i += ode_ncells) {
+    {
+      for (amrex::MFIter mfi(S_new, mfi_info); mfi.isValid(); ++mfi) {
+
+        const amrex::Box& bx = mfi.growntilebox(ng);
+
+        auto const& uold =
+          react_init ? S_new.array(mfi) : get_old_data(State_Type).array(mfi);
+        auto const& unew = S_new.array(mfi);
+        auto const& a = Ap->array(mfi);
+        amrex::FArrayBox w(bx, 1);
+        amrex::Elixir w_eli = w.elixir();
+        auto const& w_arr = w.array();
+        auto const& I_R = reactions.array(mfi);
+        const int do_update =
+          react_init ? 0 : 1; // TODO: Update here? Or just get reaction source?
+        amrex::Real wt = amrex::ParallelDescriptor::second();
 
-#ifdef USE_CUDA_SUNDIALS_PP
-            fabcost += react(
-              rY_in + i * (NUM_SPECIES + 1), rY_src_in + i * NUM_SPECIES,
-              re_in + i, re_src_in + i, &dt, &current_time, &reactor_type,
-              &ode_ncells, amrex::Gpu::gpuStream());
-#else
-            fabcost += react(
-              rY_in + i * (NUM_SPECIES + 1), rY_src_in + i * NUM_SPECIES,
-              re_in + i, re_src_in + i, &dt, &current_time);
+#ifdef PELEC_USE_EB
+        const auto& flag_fab = flags[mfi];
+        amrex::FabType typ = flag_fab.getType(bx);
+        if (typ == amrex::FabType::covered) {
+          continue;
+        } else if (
+          typ == amrex::FabType::singlevalued ||
+          typ == amrex::FabType::regular)
 #endif
-          }
-          fabcost = fabcost / ncells;
-
-          // unpack data
-          amrex::ParallelFor(
-            bx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-              w_arr(i, j, k) = fabcost;
-              amrex::Real rhou = uold(i, j, k, UMX);
-              amrex::Real rhov = uold(i, j, k, UMY);
-              amrex::Real rhow = uold(i, j, k, UMZ);
-              amrex::Real rho_old = uold(i, j, k, URHO);
-              amrex::Real rhoInv = 1.0 / rho_old;
-
-              amrex::Real rho = 0.;
-              for (int nsp = UFS; nsp < (UFS + NUM_SPECIES); nsp++) {
-                rho += uold(i, j, k, nsp);
-              }
-              amrex::Real nrg =
-                (uold(i, j, k, UEDEN) -
-                 (0.5 * (rhou * rhou + rhov * rhov + rhow * rhow) * rhoInv)) *
-                rhoInv;
-
-              rhou = unew(i, j, k, UMX);
-              rhov = unew(i, j, k, UMY);
-              rhow = unew(i, j, k, UMZ);
-              rhoInv = 1.0 / unew(i, j, k, URHO);
-
-              amrex::Real rhoedot_ext =
-                ((unew(i, j, k, UEDEN) -
-                  (0.5 * (rhou * rhou + rhov * rhov + rhow * rhow) * rhoInv)) -
-                 rho * nrg) /
-                dt;
-
-              amrex::Real umnew = uold(i, j, k, UMX) + dt * a(i, j, k, UMX);
-              amrex::Real vmnew = uold(i, j, k, UMY) + dt * a(i, j, k, UMY);
-              amrex::Real wmnew = uold(i, j, k, UMZ) + dt * a(i, j, k, UMZ);
-              amrex::Real rhonew = 0.;
-
-              int offset =
-                (k - lo.z) * len.x * len.y + (j - lo.y) * len.x + (i - lo.x);
-              for (int nsp = 0; nsp < NUM_SPECIES; nsp++) {
-                rhonew += rY_in[offset * (NUM_SPECIES + 1) + nsp];
+        {
+          react_box(bx, uold, unew, a, w_arr, I_R, dt, do_update, wall_cost);
+
+          if (do_react_load_balance) {
+            if (wall_cost && !cvode_batched) {
+              // Spread the time spent on the box over its cells in
+              // proportion to their integrator work
+              amrex::Gpu::streamSynchronize();
+              wt = amrex::ParallelDescriptor::second() - wt;
+              const amrex::Real wsum = w.sum<amrex::RunOn::Device>(bx, 0);
+              if (wsum > 0.0) {
+                w.mult<amrex::RunOn::Device>(wt / wsum, bx, 0, 1);
               }
-
-              if (do_update) {
-                unew(i, j, k, URHO) = rhonew;
-                unew(i, j, k, UMX) = umnew;
-                unew(i, j, k, UMY) = vmnew;
-                unew(i, j, k, UMZ) = wmnew;
-                for (int nsp = 0; nsp < NUM_SPECIES; nsp++) {
-                  unew(i, j, k, UFS + nsp) =
-                    rY_in[offset * (NUM_SPECIES + 1) + nsp];
-                }
-                unew(i, j, k, UTEMP) =
-                  rY_in[offset * (NUM_SPECIES + 1) + NUM_SPECIES];
-              }
-
-              for (int nsp = 0; nsp < NUM_SPECIES; nsp++) {
-                I_R(i, j, k, nsp) = (rY_in[offset * (NUM_SPECIES + 1) + nsp] -
-                                     uold(i, j, k, UFS + nsp)) /
-                                      dt -
-                                    rY_src_in[offset * (NUM_SPECIES) + nsp];
-              }
-              I_R(i, j, k, NUM_SPECIES) =
-                ((nrg * rho_old) + dt * rhoedot_ext +
-                 0.5 * (umnew * umnew + vmnew * vmnew + wmnew * wmnew) /
-                   rhonew -
-                 uold(i, j, k, UEDEN)) /
-                  dt -
-                a(i, j, k, UEDEN);
-            });
-
-          if (do_react_load_balance || do_mol_load_balance) {
-            get_new_data(Work_Estimate_Type)[mfi].plus<amrex::RunOn::Device>(w);
+            }
+            auto& cost = get_new_data(Work_Estimate_Type)[mfi];
+            const amrex::Box cbx = bx & cost.box();
+            cost.plus<amrex::RunOn::Device>(w, cbx, cbx, 0, 0, 1);
           }
-#else
-          amrex::Abort(
-            "chem_integrator=2 which requires Sundials to be enabled");
-#endif
-        } else {
-          amrex::Abort("chem_integrator must be equal to 1 or 2");
         }
       }
     }
+    amrex::Gpu::streamSynchronize();
+    chem_time = amrex::ParallelDescriptor::second() - chem_time;
   }
 
   if (ng > 0)
     S_new.FillBoundary(geom.periodicity());
 
+  if (verbose) {
+    // Ratio of the mean to the maximum time spent integrating the chemistry
+    amrex::Real chem_time_max = chem_time;
+    amrex::Real chem_time_sum = chem_time;
+    amrex::ParallelDescriptor::ReduceRealMax(chem_time_max);
+    amrex::ParallelDescriptor::ReduceRealSum(chem_time_sum);
+    const amrex::Real efficiency =
+      chem_time_max > 0.0
+        ? chem_time_sum /
+            (amrex::ParallelDescriptor::NProcs() * chem_time_max)
+        : 1.0;
+    amrex::Print() << "... Chemistry time " << chem_time_max
+                   << ", parallel efficiency " << efficiency << std::endl;
+  }
+
   if (verbose > 1) {
 
     const int IOProc = amrex::ParallelDescriptor::IOProcessorNumber();
@@ -315,3 +182,554 @@ PeleC::react_state(
 #endif
   }
 }
+
+bool
+PeleC::cvode_threads_cells()
+{
+#if defined(USE_SUNDIALS_PP) && !defined(USE_CUDA_SUNDIALS_PP)
+  return chem_integrator == 2;
+#else
+  return false;
+#endif
+}
+
+void
+PeleC::react_box(
+  const amrex::Box& bx,
+  amrex::Array4<const amrex::Real> const& uold,
+  amrex::Array4<amrex::Real> const& unew,
+  amrex::Array4<const amrex::Real> const& a,
+  amrex::Array4<amrex::Real> const& w_arr,
+  amrex::Array4<amrex::Real> const& I_R,
+  const amrex::Real dt,
+  const int do_update,
+  const bool wall_cost)
+{
+  if (chem_integrator == 1) {
+    const int nsubsteps_min = adaptrk_nsubsteps_min;
+    const int nsubsteps_max = adaptrk_nsubsteps_max;
+    const int nsubsteps_guess = adaptrk_nsubsteps_guess;
+    const amrex::Real errtol = adaptrk_errtol;
+
+    amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+      pc_expl_reactions(
+        i, j, k, uold, unew, a, w_arr, I_R, dt, nsubsteps_min, nsubsteps_max,
+        nsubsteps_guess, errtol, do_update);
+    });
+  } else if (chem_integrator == 2) {
+#ifdef USE_SUNDIALS_PP
+    const auto len = amrex::length(bx);
+    const auto lo = amrex::lbound(bx);
+    const int ncells = len.x * len.y * len.z;
+
+#ifdef USE_CUDA_SUNDIALS_PP
+    int reactor_type = 1;
+    int ode_ncells = ncells;
+    amrex::Real current_time = 0.0;
+    amrex::Real dt_react = dt;
+
+    amrex::Real* rY_in;
+    amrex::Real* rY_src_in;
+    amrex::Real* re_in;
+    amrex::Real* re_src_in;
+    cudaMallocManaged(&rY_in, (NUM_SPECIES + 1) * ncells * sizeof(amrex::Real));
+    cudaMallocManaged(&rY_src_in, NUM_SPECIES * ncells * sizeof(amrex::Real));
+    cudaMallocManaged(&re_in, ncells * sizeof(amrex::Real));
+    cudaMallocManaged(&re_src_in, ncells * sizeof(amrex::Real));
+
+    amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+      int offset = (k - lo.z) * len.x * len.y + (j - lo.y) * len.x + (i - lo.x);
+      pc_cvode_pack(
+        i, j, k, uold, unew, a, dt, rY_in + offset * (NUM_SPECIES + 1),
+        rY_src_in + offset * NUM_SPECIES, re_in[offset], re_src_in[offset]);
+    });
+
+    cudaStreamSynchronize(amrex::Gpu::gpuStream());
+    const amrex::Real fabcost =
+      static_cast<amrex::Real>(react(
+        rY_in, rY_src_in, re_in, re_src_in, &dt_react, &current_time,
+        &reactor_type, &ode_ncells, amrex::Gpu::gpuStream())) /
+      ncells;
+
+    amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+      int offset = (k - lo.z) * len.x * len.y + (j - lo.y) * len.x + (i - lo.x);
+      pc_cvode_unpack(
+        i, j, k, uold, unew, a, w_arr, I_R, dt, do_update,
+        rY_in + offset * (NUM_SPECIES + 1), rY_src_in + offset * NUM_SPECIES,
+        fabcost);
+    });
+
+    cudaStreamSynchronize(amrex::Gpu::gpuStream());
+    cudaFree(rY_in);
+    cudaFree(rY_src_in);
+    cudaFree(re_in);
+    cudaFree(re_src_in);
+#else
+    // Cells are integrated in batches of ode_ncells. A partial last batch is
+    // padded with copies of its last cell.
+    const int ode_ncells = amrex::max(1, chem_ncells);
+    const int nbatch = (ncells + ode_ncells - 1) / ode_ncells;
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int ib = 0; ib < nbatch; ++ib) {
+      int tid = 0;
+#ifdef _OPENMP
+      tid = omp_get_thread_num();
+#endif
+      amrex::Real* rY_in = react_pack_pool[tid].data();
+      amrex::Real* rY_src_in = rY_in + ode_ncells * (NUM_SPECIES + 1);
+      amrex::Real* re_in = rY_src_in + ode_ncells * NUM_SPECIES;
+      amrex::Real* re_src_in = re_in + ode_ncells;
+
+      const int first = ib * ode_ncells;
+      const int nvalid = amrex::min(ode_ncells, ncells - first);
+      for (int n = 0; n < ode_ncells; ++n) {
+        const int c = first + amrex::min(n, nvalid - 1);
+        const int i = lo.x + c % len.x;
+        const int j = lo.y + (c / len.x) % len.y;
+        const int k = lo.z + c / (len.x * len.y);
+        pc_cvode_pack(
+          i, j, k, uold, unew, a, dt, rY_in + n * (NUM_SPECIES + 1),
+          rY_src_in + n * NUM_SPECIES, re_in[n], re_src_in[n]);
+      }
+
+      amrex::Real current_time = 0.0;
+      amrex::Real dt_react = dt;
+      amrex::Real cellcost = amrex::ParallelDescriptor::second();
+      const int nfe = react(
+        rY_in, rY_src_in, re_in, re_src_in, &dt_react, &current_time);
+      cellcost = (wall_cost ? amrex::ParallelDescriptor::second() - cellcost
+                            : static_cast<amrex::Real>(nfe)) /
+                 ode_ncells;
+
+      for (int n = 0; n < nvalid; ++n) {
+        const int c = first + n;
+        const int i = lo.x + c % len.x;
+        const int j = lo.y + (c / len.x) % len.y;
+        const int k = lo.z + c / (len.x * len.y);
+        pc_cvode_unpack(
+          i, j, k, uold, unew, a, w_arr, I_R, dt, do_update,
+          rY_in + n * (NUM_SPECIES + 1), rY_src_in + n * NUM_SPECIES,
+          cellcost);
+      }
+    }
+#endif
+#else
+    amrex::Abort("chem_integrator=2 which requires Sundials to be enabled");
+#endif
+  } else {
+    amrex::Abort("chem_integrator must be equal to 1 or 2");
+  }
+}
+
+void
+PeleC::react_state_redistributed(
+  const amrex::Real dt,
+  const bool react_init,
+  const amrex::MultiFab& A,
+  amrex::Real& chem_time)
+{
+  BL_PROFILE("PeleC::react_state_redistributed()");
+
+#ifdef AMREX_USE_GPU
+  amrex::Abort("chem_redistribute is only implemented on the CPU");
+#else
+  amrex::MultiFab& S_new = get_new_data(State_Type);
+  const amrex::MultiFab& S_old =
+    react_init ? S_new : get_old_data(State_Type);
+  amrex::MultiFab& reactions = get_new_data(Reactions_Type);
+  const int ng = S_new.nGrow();
+  const int do_update = react_init ? 0 : 1;
+  const bool wall_cost = (use_reactions_work_estimate != 0);
+  const int nreact = reactions.nComp();
+
+#ifdef PELEC_USE_EB
+  auto const& fact =
+    dynamic_cast<amrex::EBFArrayBoxFactory const&>(S_new.Factory());
+  auto const& flags = fact.getMultiEBCellFlagFab();
+#endif
+
+  // Local cells, numbered box after box. The expensive ones, with a
+  // temperature above chem_redistribute_T or, when chem_redistribute_dT > 0,
+  // a chemical source that would change the temperature by more than
+  // chem_redistribute_dT over the step, may be shipped to other ranks.
+  // Each cell is weighted by its cost in the work estimate of the last step,
+  // that of the nearest valid cell in the grow cells, and without it by one
+  // for the expensive cells and zero for the others.
+  const amrex::MultiFab* cost_est =
+    (do_react_load_balance && !react_init) ? &get_old_data(Work_Estimate_Type)
+                                           : nullptr;
+  amrex::Vector<int> box_index;
+  amrex::Vector<amrex::Box> box_bx;
+  amrex::Vector<int> box_start;
+  amrex::Vector<int> expensive;
+  amrex::Vector<amrex::Real> expensive_cost;
+  amrex::Real local_cost = 0.0;
+  int ncells = 0;
+  for (amrex::MFIter mfi(S_new); mfi.isValid(); ++mfi) {
+    const amrex::Box& bx = mfi.growntilebox(ng);
+#ifdef PELEC_USE_EB
+    const amrex::FabType typ = flags[mfi].getType(bx);
+    if (
+      typ != amrex::FabType::singlevalued && typ != amrex::FabType::regular) {
+      continue;
+    }
+#endif
+    box_index.push_back(mfi.index());
+    box_bx.push_back(bx);
+    box_start.push_back(ncells);
+    auto const& uold = S_old.const_array(mfi);
+    const amrex::Box vbx = mfi.validbox();
+    for (amrex::BoxIterator bit(bx); bit.ok(); ++bit, ++ncells) {
+      const amrex::IntVect iv = bit();
+      const amrex::Dim3 c3 = iv.dim3();
+      const bool is_expensive =
+        uold(iv, UTEMP) >= chem_redistribute_T ||
+        (chem_redistribute_dT > 0.0 &&
+         pc_chem_temperature_rate(c3.x, c3.y, c3.z, uold) * dt >=
+           chem_redistribute_dT);
+      amrex::Real c = is_expensive ? 1.0 : 0.0;
+      if (cost_est != nullptr) {
+        const amrex::IntVect ivv =
+          amrex::min(amrex::max(iv, vbx.smallEnd()), vbx.bigEnd());
+        c = amrex::max((*cost_est)[mfi](ivv, 0), amrex::Real(0.0));
+      }
+      local_cost += c;
+      if (is_expensive) {
+        expensive.push_back(ncells);
+        expensive_cost.push_back(c);
+      }
+    }
+  }
+  box_start.push_back(ncells);
+
+  // Box and position of a local cell
+  auto cell_at = [&](const int c, int& b, amrex::IntVect& iv) {
+    b = static_cast<int>(
+      std::upper_bound(box_start.begin(), box_start.end(), c) -
+      box_start.begin() - 1);
+    iv = box_bx[b].atOffset(c - box_start[b]);
+  };
+
+  // Pair the ranks holding more than their share of the cost with the ranks
+  // holding less. The plan is identical on all ranks.
+  const int nprocs = amrex::ParallelDescriptor::NProcs();
+  const int myproc = amrex::ParallelDescriptor::MyProc();
+  amrex::Vector<amrex::Real> surplus(nprocs, 0.0);
+  surplus[myproc] = local_cost;
+  amrex::ParallelDescriptor::ReduceRealSum(surplus.data(), nprocs);
+  amrex::Real total = 0.0;
+  for (int p = 0; p < nprocs; ++p) {
+    total += surplus[p];
+  }
+  const amrex::Real eps = 1.0e-6 * total / nprocs;
+  for (int p = 0; p < nprocs; ++p) {
+    surplus[p] -= total / nprocs;
+  }
+
+  struct Transfer
+  {
+    int src;
+    int dst;
+    amrex::Real cost;
+  };
+  amrex::Vector<Transfer> plan;
+  for (int src = 0, dst = 0; src < nprocs; ++src) {
+    while (surplus[src] > eps) {
+      while (dst < nprocs && surplus[dst] >= -eps) {
+        ++dst;
+      }
+      if (dst == nprocs) {
+        break;
+      }
+      const amrex::Real c = amrex::min(surplus[src], -surplus[dst]);
+      plan.push_back({src, dst, c});
+      surplus[src] -= c;
+      surplus[dst] += c;
+    }
+  }
+
+  // Each sender ships its last expensive cells until the cost of the
+  // transfer is reached, the transfers taken from the last one so that the
+  // cells are in increasing order over the plan. The number of cells of each
+  // transfer is then made known to all ranks.
+  const int ntransfers = static_cast<int>(plan.size());
+  amrex::Vector<int> ncells_transfer(ntransfers, 0);
+  int nsend = 0;
+  {
+    int next = static_cast<int>(expensive.size());
+    for (int t = ntransfers - 1; t >= 0; --t) {
+      if (plan[t].src != myproc) {
+        continue;
+      }
+      amrex::Real sent = 0.0;
+      while (next > 0 && sent < plan[t].cost) {
+        --next;
+        sent += expensive_cost[next];
+        ++ncells_transfer[t];
+      }
+      nsend += ncells_transfer[t];
+    }
+  }
+  if (ntransfers > 0) {
+    amrex::ParallelDescriptor::ReduceIntSum(
+      ncells_transfer.data(), ntransfers);
+  }
+  int nrecv = 0;
+  for (int t = 0; t < ntransfers; ++t) {
+    if (plan[t].dst == myproc) {
+      nrecv += ncells_transfer[t];
+    }
+  }
+
+  // The last nsend expensive cells are shipped, in increasing order, all
+  // others stay here
+  const int nkept = ncells - nsend;
+  const int* shipped = expensive.data() + expensive.size() - nsend;
+  auto for_each_kept = [&](auto&& f) {
+    int m = 0;
+    int s = 0;
+    for (int c = 0; c < ncells; ++c) {
+      if (s < nsend && shipped[s] == c) {
+        ++s;
+        continue;
+      }
+      f(m++, c);
+    }
+  };
+
+  // A message holds uold, unew and the source of a cell. The reply holds
+  // unew, the reaction source and the cost.
+  const int nmsg = 3 * NVAR;
+  const int nreply = NVAR + nreact + 1;
+  auto pack_cell = [&](const int c, amrex::Real* buf) {
+    int b;
+    amrex::IntVect iv;
+    cell_at(c, b, iv);
+    auto const& uo = S_old.const_array(box_index[b]);
+    auto const& un = S_new.const_array(box_index[b]);
+    auto const& ac = A.const_array(box_index[b]);
+    for (int n = 0; n < NVAR; ++n) {
+      buf[n] = uo(iv, n);
+      buf[NVAR + n] = un(iv, n);
+      buf[2 * NVAR + n] = ac(iv, n);
+    }
+  };
+
+  amrex::Vector<amrex::Real> sendbuf(static_cast<size_t>(nsend) * nmsg);
+  for (int n = 0; n < nsend; ++n) {
+    pack_cell(shipped[n], sendbuf.data() + static_cast<size_t>(n) * nmsg);
+  }
+  amrex::Vector<amrex::Real> recvbuf(static_cast<size_t>(nrecv) * nmsg);
+
+#ifdef BL_USE_MPI
+  MPI_Comm comm = amrex::ParallelDescriptor::Communicator();
+  MPI_Datatype mpi_real =
+    amrex::ParallelDescriptor::Mpi_typemap<amrex::Real>::type();
+  const int tag = amrex::ParallelDescriptor::SeqNum();
+  amrex::Vector<MPI_Request> reqs;
+  {
+    size_t soff = 0, roff = 0;
+    for (int it = 0; it < ntransfers; ++it) {
+      const Transfer& t = plan[it];
+      const int nc = ncells_transfer[it];
+      if (nc == 0) {
+        continue;
+      }
+      if (t.dst == myproc) {
+        reqs.push_back(MPI_REQUEST_NULL);
+        MPI_Irecv(
+          recvbuf.data() + roff, nc * nmsg, mpi_real, t.src, tag, comm,
+          &reqs.back());
+        roff += static_cast<size_t>(nc) * nmsg;
+      }
+      if (t.src == myproc) {
+        reqs.push_back(MPI_REQUEST_NULL);
+        MPI_Isend(
+          sendbuf.data() + soff, nc * nmsg, mpi_real, t.dst, tag, comm,
+          &reqs.back());
+        soff += static_cast<size_t>(nc) * nmsg;
+      }
+    }
+  }
+#endif
+
+  // Integrate the kept cells, then the received ones, as a single row of
+  // cells
+  const int nint = nkept + nrecv;
+  chem_time = amrex::ParallelDescriptor::second();
+  amrex::FArrayBox uold_c, unew_c, a_c, w_c, ir_c;
+  if (nint > 0) {
+    const amrex::Box cbx(
+      amrex::IntVect::TheZeroVector(),
+      amrex::IntVect(AMREX_D_DECL(nint - 1, 0, 0)));
+    uold_c.resize(cbx, NVAR);
+    unew_c.resize(cbx, NVAR);
+    a_c.resize(cbx, NVAR);
+    w_c.resize(cbx, 1);
+    ir_c.resize(cbx, nreact);
+    auto const& uo = uold_c.array();
+    auto const& un = unew_c.array();
+    auto const& ac = a_c.array();
+
+    amrex::Vector<amrex::Real> cell(nmsg);
+    for_each_kept([&](const int m, const int c) {
+      pack_cell(c, cell.data());
+      for (int n = 0; n < NVAR; ++n) {
+        uo(m, 0, 0, n) = cell[n];
+        un(m, 0, 0, n) = cell[NVAR + n];
+        ac(m, 0, 0, n) = cell[2 * NVAR + n];
+      }
+    });
+
+#ifdef BL_USE_MPI
+    MPI_Waitall(
+      static_cast<int>(reqs.size()), reqs.data(), MPI_STATUSES_IGNORE);
+    reqs.clear();
+#endif
+    for (int m = 0; m < nrecv; ++m) {
+      const amrex::Real* buf = recvbuf.data() + static_cast<size_t>(m) * nmsg;
+      for (int n = 0; n < NVAR; ++n) {
+        uo(nkept + m, 0, 0, n) = buf[n];
+        un(nkept + m, 0, 0, n) = buf[NVAR + n];
+        ac(nkept + m, 0, 0, n) = buf[2 * NVAR + n];
+      }
+    }
+
+    amrex::Real wt = amrex::ParallelDescriptor::second();
+    if (cvode_threads_cells()) {
+      react_box(
+        cbx, uold_c.const_array(), un, a_c.const_array(), w_c.array(),
+        ir_c.array(), dt, do_update, wall_cost);
+    } else {
+      // Chunks of the row are handed to the threads as they free up
+      const int chunk = 64;
+      const int nchunk = (nint + chunk - 1) / chunk;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+      for (int ic = 0; ic < nchunk; ++ic) {
+        const amrex::Box sbx(
+          amrex::IntVect(AMREX_D_DECL(ic * chunk, 0, 0)),
+          amrex::IntVect(
+            AMREX_D_DECL(amrex::min((ic + 1) * chunk, nint) - 1, 0, 0)));
+        react_box(
+          sbx, uold_c.const_array(), un, a_c.const_array(), w_c.array(),
+          ir_c.array(), dt, do_update, wall_cost);
+      }
+      if (wall_cost) {
+        wt = amrex::ParallelDescriptor::second() - wt;
+        const amrex::Real wsum = w_c.sum<amrex::RunOn::Host>(cbx, 0);
+        if (wsum > 0.0) {
+          w_c.mult<amrex::RunOn::Host>(wt / wsum, cbx, 0, 1);
+        }
+      }
+    }
+  }
+  chem_time = amrex::ParallelDescriptor::second() - chem_time;
+
+#ifdef BL_USE_MPI
+  if (!reqs.empty()) {
+    MPI_Waitall(
+      static_cast<int>(reqs.size()), reqs.data(), MPI_STATUSES_IGNORE);
+    reqs.clear();
+  }
+#endif
+
+  // Send the results of the received cells back to their owners
+  amrex::Vector<amrex::Real> replybuf(static_cast<size_t>(nrecv) * nreply);
+  for (int m = 0; m < nrecv; ++m) {
+    amrex::Real* buf = replybuf.data() + static_cast<size_t>(m) * nreply;
+    const amrex::IntVect iv(AMREX_D_DECL(nkept + m, 0, 0));
+    for (int n = 0; n < NVAR; ++n) {
+      buf[n] = unew_c(iv, n);
+    }
+    for (int n = 0; n < nreact; ++n) {
+      buf[NVAR + n] = ir_c(iv, n);
+    }
+    buf[NVAR + nreact] = w_c(iv, 0);
+  }
+  amrex::Vector<amrex::Real> resultbuf(static_cast<size_t>(nsend) * nreply);
+
+#ifdef BL_USE_MPI
+  {
+    size_t soff = 0, roff = 0;
+    for (int it = 0; it < ntransfers; ++it) {
+      const Transfer& t = plan[it];
+      const int nc = ncells_transfer[it];
+      if (nc == 0) {
+        continue;
+      }
+      if (t.src == myproc) {
+        reqs.push_back(MPI_REQUEST_NULL);
+        MPI_Irecv(
+          resultbuf.data() + roff, nc * nreply, mpi_real, t.dst, tag, comm,
+          &reqs.back());
+        roff += static_cast<size_t>(nc) * nreply;
+      }
+      if (t.dst == myproc) {
+        reqs.push_back(MPI_REQUEST_NULL);
+        MPI_Isend(
+          replybuf.data() + soff, nc * nreply, mpi_real, t.src, tag, comm,
+          &reqs.back());
+        soff += static_cast<size_t>(nc) * nreply;
+      }
+    }
+  }
+#endif
+
+  // Scatter the results into the state, the reaction source and the work
+  // estimate
+  amrex::MultiFab* cost =
+    do_react_load_balance ? &get_new_data(Work_Estimate_Type) : nullptr;
+  auto scatter_cell = [&](const int c, const amrex::Real* un,
+                          const amrex::Real* ir, const amrex::Real w) {
+    int b;
+    amrex::IntVect iv;
+    cell_at(c, b, iv);
+    const int i = box_index[b];
+    auto const& unew = S_new.array(i);
+    for (int n = 0; n < NVAR; ++n) {
+      unew(iv, n) = un[n];
+    }
+    if (reactions[i].box().contains(iv)) {
+      auto const& I_R = reactions.array(i);
+      for (int n = 0; n < nreact; ++n) {
+        I_R(iv, n) = ir[n];
+      }
+    }
+    if (cost != nullptr && (*cost)[i].box().contains(iv)) {
+      cost->array(i)(iv, 0) += w;
+    }
+  };
+
+  amrex::Vector<amrex::Real> un(NVAR), ir(nreact);
+  for_each_kept([&](const int m, const int c) {
+    const amrex::IntVect iv(AMREX_D_DECL(m, 0, 0));
+    for (int n = 0; n < NVAR; ++n) {
+      un[n] = unew_c(iv, n);
+    }
+    for (int n = 0; n < nreact; ++n) {
+      ir[n] = ir_c(iv, n);
+    }
+    scatter_cell(c, un.data(), ir.data(), w_c(iv, 0));
+  });
+
+#ifdef BL_USE_MPI
+  MPI_Waitall(static_cast<int>(reqs.size()), reqs.data(), MPI_STATUSES_IGNORE);
+#endif
+  for (int m = 0; m < nsend; ++m) {
+    const amrex::Real* buf = resultbuf.data() + static_cast<size_t>(m) * nreply;
+    scatter_cell(shipped[m], buf, buf + NVAR, buf[NVAR + nreact]);
+  }
+
+  if (verbose > 1) {
+    long moved = nsend;
+    amrex::ParallelDescriptor::ReduceLongSum(moved);
+    amrex::Print() << "... Chemistry redistribution moved " << moved
+                   << " expensive cells, total cost " << total << std::endl;
+  }
+#endif
+}
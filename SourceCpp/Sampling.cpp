@@ -0,0 +1,379 @@
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <memory>
+
+#include <AMReX_ParmParse.H>
+#include <AMReX_Utility.H>
+
+#include "PeleC.H"
+#include "Sampling.H"
+
+namespace sampling_params {
+int interval = -1;
+amrex::Real per = -1.0;
+std::string output_dir = "samples";
+amrex::Vector<std::string> vars;
+amrex::Vector<SampleSet> sets;
+} // namespace sampling_params
+
+namespace {
+
+SampleSet
+read_sample_set(const std::string& name)
+{
+  amrex::ParmParse pp("sampling." + name);
+  SampleSet s;
+  s.name = name;
+  std::string type;
+  pp.get("type", type);
+  if (type == "points") {
+    s.type = sample_points;
+    pp.getarr("points", s.x);
+    if (s.x.empty() || s.x.size() % AMREX_SPACEDIM != 0) {
+      amrex::Abort(
+        "sampling." + name + ".points needs AMREX_SPACEDIM values per point");
+    }
+    s.npts[0] = s.num_points();
+  } else if (type == "line") {
+    amrex::Vector<amrex::Real> start, end;
+    int n = 0;
+    pp.getarr("start", start, 0, AMREX_SPACEDIM);
+    pp.getarr("end", end, 0, AMREX_SPACEDIM);
+    pp.get("num_points", n);
+    if (n < 1) {
+      amrex::Abort("sampling." + name + ".num_points must be positive");
+    }
+    sample_line_points(start.data(), end.data(), n, s);
+  } else if (type == "plane") {
+    amrex::Vector<amrex::Real> origin, axis1, axis2;
+    amrex::Vector<int> n;
+    pp.getarr("origin", origin, 0, AMREX_SPACEDIM);
+    pp.getarr("axis1", axis1, 0, AMREX_SPACEDIM);
+    pp.getarr("axis2", axis2, 0, AMREX_SPACEDIM);
+    pp.getarr("num_points", n, 0, 2);
+    if (n[0] < 1 || n[1] < 1) {
+      amrex::Abort("sampling." + name + ".num_points must be positive");
+    }
+    sample_plane_points(origin.data(), axis1.data(), axis2.data(), &n[0], s);
+  } else {
+    amrex::Abort(
+      "sampling." + name + ".type must be points, line or plane, not " + type);
+  }
+
+  const amrex::Real* plo = amrex::DefaultGeometry().ProbLo();
+  const amrex::Real* phi = amrex::DefaultGeometry().ProbHi();
+  for (int p = 0; p < s.num_points(); p++) {
+    for (int d = 0; d < AMREX_SPACEDIM; d++) {
+      const amrex::Real xd = s.x[p * AMREX_SPACEDIM + d];
+      if (xd < plo[d] || xd > phi[d]) {
+        amrex::Abort("sampling." + name + ": point outside of the domain");
+      }
+    }
+  }
+  return s;
+}
+
+const char*
+sample_type_name(const int type)
+{
+  return (type == sample_line) ? "line"
+                               : ((type == sample_plane) ? "plane" : "points");
+}
+
+// Describes the binary records of a set, rewritten at each start
+void
+write_sample_header(const SampleSet& s, const std::string& fname)
+{
+  std::ofstream ofs(fname.c_str());
+  if (!ofs.good()) {
+    amrex::FileOpenFailed(fname);
+  }
+  const auto& vars = sampling_params::vars;
+  ofs << "PeleC samples 1\n";
+  ofs << "type " << sample_type_name(s.type) << '\n';
+  ofs << "num_points " << s.num_points() << ' ' << s.npts[0] << ' '
+      << s.npts[1] << '\n';
+  ofs << "num_vars " << vars.size() << '\n';
+  for (int v = 0; v < vars.size(); v++) {
+    ofs << vars[v] << ((v + 1 < vars.size()) ? ' ' : '\n');
+  }
+  ofs << "record float64 time, int64 step, "
+      << "float64 values[num_points][num_vars]\n";
+  ofs << std::setprecision(17);
+  for (int p = 0; p < s.num_points(); p++) {
+    for (int d = 0; d < AMREX_SPACEDIM; d++) {
+      ofs << s.x[p * AMREX_SPACEDIM + d]
+          << ((d + 1 < AMREX_SPACEDIM) ? ' ' : '\n');
+    }
+  }
+}
+
+} // namespace
+
+void
+sample_line_points(
+  const amrex::Real* start, const amrex::Real* end, const int n, SampleSet& s)
+{
+  s.type = sample_line;
+  s.npts[0] = n;
+  s.npts[1] = 1;
+  s.x.resize(n * AMREX_SPACEDIM);
+  for (int p = 0; p < n; p++) {
+    const amrex::Real f = (n > 1) ? static_cast<amrex::Real>(p) / (n - 1) : 0.0;
+    for (int d = 0; d < AMREX_SPACEDIM; d++) {
+      s.x[p * AMREX_SPACEDIM + d] = start[d] + f * (end[d] - start[d]);
+    }
+  }
+}
+
+void
+sample_plane_points(
+  const amrex::Real* origin,
+  const amrex::Real* axis1,
+  const amrex::Real* axis2,
+  const int n[2],
+  SampleSet& s)
+{
+  s.type = sample_plane;
+  s.npts[0] = n[0];
+  s.npts[1] = n[1];
+  s.x.resize(n[0] * n[1] * AMREX_SPACEDIM);
+  for (int q = 0; q < n[1]; q++) {
+    const amrex::Real g =
+      (n[1] > 1) ? static_cast<amrex::Real>(q) / (n[1] - 1) : 0.0;
+    for (int p = 0; p < n[0]; p++) {
+      const amrex::Real f =
+        (n[0] > 1) ? static_cast<amrex::Real>(p) / (n[0] - 1) : 0.0;
+      const int m = q * n[0] + p;
+      for (int d = 0; d < AMREX_SPACEDIM; d++) {
+        s.x[m * AMREX_SPACEDIM + d] = origin[d] + f * axis1[d] + g * axis2[d];
+      }
+    }
+  }
+}
+
+bool
+sampling_due(const int nstep, const amrex::Real time, const amrex::Real dt)
+{
+  if (sampling_params::sets.empty()) {
+    return false;
+  }
+  if (sampling_params::interval > 0 && nstep % sampling_params::interval == 0) {
+    return true;
+  }
+  if (sampling_params::per > 0.0) {
+    const int num_per_old =
+      amrex::Math::floor((time - dt) / sampling_params::per);
+    const int num_per_new = amrex::Math::floor(time / sampling_params::per);
+    return num_per_old != num_per_new;
+  }
+  return false;
+}
+
+void
+PeleC::read_sampling_params()
+{
+  amrex::ParmParse pp("sampling");
+
+  pp.query("interval", sampling_params::interval);
+  pp.query("per", sampling_params::per);
+  pp.query("output_dir", sampling_params::output_dir);
+
+  amrex::Vector<std::string> names;
+  pp.queryarr("sets", names);
+  if (names.empty()) {
+    return;
+  }
+  pp.getarr("vars", sampling_params::vars);
+  for (const auto& name : names) {
+    sampling_params::sets.push_back(read_sample_set(name));
+  }
+}
+
+std::unique_ptr<amrex::MultiFab>
+PeleC::sample_multifab(amrex::Real time)
+{
+  BL_PROFILE("PeleC::sample_multifab()");
+
+  // One ghost cell for the interpolation across the grids
+  const auto& vars = sampling_params::vars;
+  const int ng = 1;
+  auto mf = std::make_unique<amrex::MultiFab>(
+    grids, dmap, vars.size(), ng, amrex::MFInfo(), Factory());
+  for (int v = 0; v < vars.size(); v++) {
+    int typ, comp;
+    if (isStateVariable(vars[v], typ, comp)) {
+      FillPatch(*this, *mf, ng, time, typ, comp, 1, v);
+    } else {
+      auto derive_dat = derive(vars[v], time, ng);
+      amrex::MultiFab::Copy(*mf, *derive_dat, 0, v, 1, ng);
+    }
+  }
+  return mf;
+}
+
+void
+PeleC::sample_solution(const bool fresh)
+{
+  BL_PROFILE("PeleC::sample_solution()");
+  AMREX_ASSERT(level == 0);
+
+  const auto& vars = sampling_params::vars;
+  const auto& sets = sampling_params::sets;
+  const int nvars = vars.size();
+  static bool checked = false;
+  if (!checked) {
+    for (const auto& name : vars) {
+      int typ, comp;
+      const amrex::DeriveRec* rec = derive_lst.get(name);
+      if (
+        !isStateVariable(name, typ, comp) &&
+        (rec == nullptr || rec->numDerive() != 1)) {
+        amrex::Abort(
+          "sampling.vars: " + name +
+          " is neither a state variable nor a one component derived one");
+      }
+    }
+    checked = true;
+  }
+
+  // Each point is sampled by the owner of the finest grid over it. The
+  // owners follow from the grids, so that the root knows where each value
+  // comes from and a single gather collects all the sets.
+  const int finest_level = parent->finestLevel();
+  const int nprocs = amrex::ParallelDescriptor::NProcs();
+  const int myproc = amrex::ParallelDescriptor::MyProc();
+  amrex::Vector<int> owner;
+  amrex::Vector<int> level_used(finest_level + 1, 0);
+  std::vector<int> counts(nprocs, 0);
+  std::map<std::pair<int, int>, amrex::Vector<int>> my_points;
+  amrex::Vector<const amrex::Real*> my_x;
+  for (const auto& s : sets) {
+    for (int p = 0; p < s.num_points(); p++) {
+      const amrex::Real* x = &s.x[p * AMREX_SPACEDIM];
+      for (int lev = finest_level; lev >= 0; lev--) {
+        const amrex::Geometry& g = parent->Geom(lev);
+        amrex::IntVect iv;
+        for (int d = 0; d < AMREX_SPACEDIM; d++) {
+          iv[d] = amrex::min(
+            static_cast<int>(
+              amrex::Math::floor((x[d] - g.ProbLo(d)) * g.InvCellSize(d))),
+            g.Domain().bigEnd(d));
+        }
+        const auto isects =
+          parent->boxArray(lev).intersections(amrex::Box(iv, iv), true, 0);
+        if (!isects.empty()) {
+          const int box = isects[0].first;
+          const int rank = parent->DistributionMap(lev)[box];
+          owner.push_back(rank);
+          level_used[lev] = 1;
+          counts[rank] += nvars;
+          if (rank == myproc) {
+            my_points[std::make_pair(lev, box)].push_back(my_x.size());
+            my_x.push_back(x);
+          }
+          break;
+        }
+      }
+    }
+  }
+
+  const amrex::Real time = state[State_Type].curTime();
+  amrex::Gpu::DeviceVector<amrex::Real> d_send(my_x.size() * nvars);
+  amrex::Real* send = d_send.data();
+  for (int lev = 0; lev <= finest_level; lev++) {
+    if (level_used[lev] == 0) {
+      continue;
+    }
+    auto mf = getLevel(lev).sample_multifab(time);
+    const amrex::Geometry& g = parent->Geom(lev);
+    const auto plo = g.ProbLoArray();
+    const auto dxinv = g.InvCellSizeArray();
+    for (amrex::MFIter mfi(*mf); mfi.isValid(); ++mfi) {
+      const auto it = my_points.find(std::make_pair(lev, mfi.index()));
+      if (it == my_points.end()) {
+        continue;
+      }
+      const auto& slots = it->second;
+      const int n = slots.size();
+      amrex::Vector<amrex::Real> hx(n * AMREX_SPACEDIM);
+      for (int m = 0; m < n; m++) {
+        for (int d = 0; d < AMREX_SPACEDIM; d++) {
+          hx[m * AMREX_SPACEDIM + d] = my_x[slots[m]][d];
+        }
+      }
+      amrex::Gpu::DeviceVector<amrex::Real> d_x(hx.size());
+      amrex::Gpu::DeviceVector<int> d_slots(n);
+      amrex::Gpu::htod_memcpy(
+        d_x.data(), hx.data(), hx.size() * sizeof(amrex::Real));
+      amrex::Gpu::htod_memcpy(d_slots.data(), slots.data(), n * sizeof(int));
+      const amrex::Real* xp = d_x.data();
+      const int* sp = d_slots.data();
+      auto const& q = mf->const_array(mfi);
+      amrex::ParallelFor(n, [=] AMREX_GPU_DEVICE(int m) noexcept {
+        for (int v = 0; v < nvars; v++) {
+          send[sp[m] * nvars + v] =
+            pc_sample_interp(xp + m * AMREX_SPACEDIM, plo, dxinv, q, v);
+        }
+      });
+      amrex::Gpu::streamSynchronize();
+    }
+  }
+  amrex::Vector<amrex::Real> h_send(d_send.size());
+  amrex::Gpu::dtoh_memcpy(
+    h_send.data(), send, h_send.size() * sizeof(amrex::Real));
+
+  const int ioproc = amrex::ParallelDescriptor::IOProcessorNumber();
+  std::vector<int> disp(nprocs, 0);
+  for (int r = 1; r < nprocs; r++) {
+    disp[r] = disp[r - 1] + counts[r - 1];
+  }
+  amrex::Vector<amrex::Real> recv(
+    amrex::ParallelDescriptor::IOProcessor() ? owner.size() * nvars : 0);
+  amrex::ParallelDescriptor::Gatherv(
+    h_send.data(), static_cast<int>(h_send.size()), recv.data(), counts, disp,
+    ioproc);
+
+  if (!amrex::ParallelDescriptor::IOProcessor()) {
+    return;
+  }
+  static bool started = false;
+  if (!started) {
+    if (!amrex::UtilCreateDirectory(sampling_params::output_dir, 0755)) {
+      amrex::CreateDirectoryFailed(sampling_params::output_dir);
+    }
+  }
+  const std::int64_t nstep = parent->levelSteps(0);
+  amrex::Vector<amrex::Real> values;
+  int p_all = 0;
+  for (const auto& s : sets) {
+    // Back to the point order, from the ranks in order
+    values.resize(s.num_points() * nvars);
+    for (int p = 0; p < s.num_points(); p++, p_all++) {
+      const int r = owner[p_all];
+      for (int v = 0; v < nvars; v++) {
+        values[p * nvars + v] = recv[disp[r] + v];
+      }
+      disp[r] += nvars;
+    }
+
+    const std::string base = sampling_params::output_dir + "/" + s.name;
+    if (!started) {
+      write_sample_header(s, base + ".hdr");
+    }
+    const auto mode = (!started && fresh) ? std::ios::trunc : std::ios::app;
+    std::ofstream ofs(
+      (base + ".bin").c_str(), std::ios::out | std::ios::binary | mode);
+    if (!ofs.good()) {
+      amrex::FileOpenFailed(base + ".bin");
+    }
+    ofs.write(reinterpret_cast<const char*>(&time), sizeof(time));
+    ofs.write(reinterpret_cast<const char*>(&nstep), sizeof(nstep));
+    ofs.write(
+      reinterpret_cast<const char*>(values.data()),
+      values.size() * sizeof(amrex::Real));
+  }
+  started = true;
+}
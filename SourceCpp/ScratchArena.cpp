@@ -0,0 +1,116 @@
+#include <AMReX_Gpu.H>
+
+#include "ScratchArena.H"
+
+ScratchArena::~ScratchArena() { release(); }
+
+void
+ScratchArena::define(bool a_enabled, std::size_t nreal)
+{
+  m_enabled = a_enabled;
+  if (!m_enabled) {
+    release();
+    return;
+  }
+
+  nreal = aligned(nreal);
+  if (nreal > m_capacity) {
+    release();
+    m_data = static_cast<amrex::Real*>(
+      amrex::The_Arena()->alloc(nreal * sizeof(amrex::Real)));
+    m_capacity = nreal;
+    m_bytes_allocated += nreal * sizeof(amrex::Real);
+  }
+  m_offset = 0;
+  m_demand = 0;
+}
+
+void
+ScratchArena::reset()
+{
+  if (!m_enabled) {
+    return;
+  }
+
+  // The buffer is reused by the next tile without waiting, its kernels being
+  // queued on the same stream after those of the previous tile. Only memory
+  // returned to the system arena needs these kernels to be done.
+  if (m_overflow.empty() && m_demand <= m_capacity) {
+    m_offset = 0;
+    m_demand = 0;
+    return;
+  }
+  amrex::Gpu::synchronize();
+
+  for (auto* p : m_overflow) {
+    amrex::The_Arena()->free(p);
+  }
+  m_overflow.clear();
+
+  // Grow to the high-water mark so that the next tile fits in one buffer
+  if (m_demand > m_capacity) {
+    if (m_data != nullptr) {
+      amrex::The_Arena()->free(m_data);
+    }
+    m_data = static_cast<amrex::Real*>(
+      amrex::The_Arena()->alloc(m_demand * sizeof(amrex::Real)));
+    m_capacity = m_demand;
+    m_bytes_allocated += m_demand * sizeof(amrex::Real);
+  }
+
+  m_offset = 0;
+  m_demand = 0;
+}
+
+amrex::FArrayBox
+ScratchArena::make_fab(const amrex::Box& bx, int ncomp)
+{
+  if (!m_enabled) {
+    amrex::FArrayBox fab(bx, ncomp);
+    m_bytes_allocated += fab.nBytes();
+    return fab;
+  }
+
+  const std::size_t nreal = static_cast<std::size_t>(bx.numPts()) * ncomp;
+  return amrex::FArrayBox(bx, ncomp, grab(nreal));
+}
+
+amrex::Real*
+ScratchArena::grab(std::size_t nreal)
+{
+  nreal = aligned(nreal);
+  m_demand += nreal;
+
+  if (m_offset + nreal <= m_capacity) {
+    amrex::Real* p = m_data + m_offset;
+    m_offset += nreal;
+    return p;
+  }
+
+  amrex::Real* p = static_cast<amrex::Real*>(
+    amrex::The_Arena()->alloc(nreal * sizeof(amrex::Real)));
+  m_overflow.push_back(p);
+  m_bytes_allocated += nreal * sizeof(amrex::Real);
+  return p;
+}
+
+void
+ScratchArena::release()
+{
+  if (m_data == nullptr && m_overflow.empty()) {
+    return;
+  }
+
+  amrex::Gpu::synchronize();
+  for (auto* p : m_overflow) {
+    amrex::The_Arena()->free(p);
+  }
+  m_overflow.clear();
+  if (m_data != nullptr) {
+    amrex::The_Arena()->free(m_data);
+    m_data = nullptr;
+  }
+  m_capacity = 0;
+  m_offset = 0;
+  m_demand = 0;
+}
@@ -0,0 +1,417 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <sstream>
+#include <utility>
+
+#include <AMReX.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_Vector.H>
+
+#include "StlGeometry.H"
+
+namespace {
+
+// Triangles per leaf of the hierarchy
+const int leaf_size = 4;
+
+// Deepest hierarchy of the median splits, 2^64 triangles being out of reach
+const int max_depth = 64;
+
+amrex::Real
+dot(const StlPoint& a, const StlPoint& b)
+{
+  return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+StlPoint
+sub(const StlPoint& a, const StlPoint& b)
+{
+  return {a[0] - b[0], a[1] - b[1], a[2] - b[2]};
+}
+
+// Squared distance from p to a + s u + t v
+amrex::Real
+dist2(
+  const StlPoint& p,
+  const StlPoint& a,
+  const StlPoint& u,
+  const amrex::Real s,
+  const StlPoint& v,
+  const amrex::Real t)
+{
+  const StlPoint q = {
+    a[0] + s * u[0] + t * v[0], a[1] + s * u[1] + t * v[1],
+    a[2] + s * u[2] + t * v[2]};
+  const StlPoint d = sub(p, q);
+  return dot(d, d);
+}
+
+// Squared distance from p to the box of a node, 0 in the box
+amrex::Real
+box_dist2(const StlPoint& p, const StlIF::Node& node)
+{
+  const amrex::Real zero = 0.0;
+  amrex::Real d2 = 0.0;
+  for (int d = 0; d < 3; d++) {
+    const amrex::Real e =
+      std::max(std::max(node.lo[d] - p[d], zero), p[d] - node.hi[d]);
+    d2 += e * e;
+  }
+  return d2;
+}
+
+// Edge function of a -> b at p in the (y, z) plane, positive on the left.
+// It is evaluated from the lower end of the edge so that the two triangles
+// sharing an edge get exactly opposite values.
+amrex::Real
+edge_yz(const StlPoint& a, const StlPoint& b, const StlPoint& p)
+{
+  const bool ab = (a[1] < b[1]) || (a[1] == b[1] && a[2] < b[2]);
+  const StlPoint& o = ab ? a : b;
+  const amrex::Real e = (b[1] - a[1]) * (p[2] - o[2]) -
+                        (b[2] - a[2]) * (p[1] - o[1]);
+  return e;
+}
+
+// Whether p, moved by an infinitesimal (0, eps, eps^2), is on the left of
+// a -> b: the top-left rule, which counts the points on the edges and
+// vertices of the triangles in exactly one of them
+bool
+covers(const StlPoint& a, const StlPoint& b, const StlPoint& p)
+{
+  const amrex::Real e = edge_yz(a, b, p);
+  if (e != 0.0) {
+    return e > 0.0;
+  }
+  if (b[2] != a[2]) {
+    return b[2] < a[2];
+  }
+  return b[1] > a[1];
+}
+
+// Whether the ray from p along x crosses the triangle t
+int
+ray_crosses(const StlPoint& p, const StlTriangle& t)
+{
+  const StlPoint& a = t.v[0];
+  StlPoint b = t.v[1];
+  StlPoint c = t.v[2];
+  amrex::Real area = edge_yz(a, b, c);
+  if (area == 0.0) {
+    return 0;
+  }
+  // Counter-clockwise in the (y, z) plane
+  if (area < 0.0) {
+    std::swap(b, c);
+    area = -area;
+  }
+  if (!covers(a, b, p) || !covers(b, c, p) || !covers(c, a, p)) {
+    return 0;
+  }
+  const amrex::Real x =
+    (edge_yz(b, c, p) * a[0] + edge_yz(c, a, p) * b[0] +
+     edge_yz(a, b, p) * c[0]) /
+    area;
+  return (x > p[0]) ? 1 : 0;
+}
+
+// Hierarchy of the triangles with a non zero area, reordered along the
+// leaves
+std::shared_ptr<const StlIF::Bvh>
+make_bvh(std::vector<StlTriangle> tris)
+{
+  auto bvh = std::make_shared<StlIF::Bvh>();
+  for (const auto& t : tris) {
+    const StlPoint u = sub(t.v[1], t.v[0]);
+    const StlPoint v = sub(t.v[2], t.v[0]);
+    const StlPoint n = {
+      u[1] * v[2] - u[2] * v[1], u[2] * v[0] - u[0] * v[2],
+      u[0] * v[1] - u[1] * v[0]};
+    if (dot(n, n) > 0.0) {
+      bvh->tris.push_back(t);
+    }
+  }
+  const int ntri = bvh->tris.size();
+  if (ntri == 0) {
+    amrex::Abort("StlIF: no triangles in the surface");
+  }
+
+  std::vector<StlPoint> cent(ntri);
+  std::vector<int> order(ntri);
+  for (int i = 0; i < ntri; i++) {
+    const StlTriangle& t = bvh->tris[i];
+    for (int d = 0; d < 3; d++) {
+      cent[i][d] = (t.v[0][d] + t.v[1][d] + t.v[2][d]) / 3.0;
+    }
+    order[i] = i;
+  }
+
+  auto& nodes = bvh->nodes;
+  nodes.reserve(2 * (ntri / leaf_size + 1));
+  nodes.emplace_back();
+  nodes[0].count = ntri;
+  std::vector<int> stack(1, 0);
+  while (!stack.empty()) {
+    const int in = stack.back();
+    stack.pop_back();
+    StlIF::Node node = nodes[in];
+    const int first = node.first;
+    const int last = node.first + node.count;
+
+    StlPoint clo = cent[order[first]];
+    StlPoint chi = clo;
+    node.lo = bvh->tris[order[first]].v[0];
+    node.hi = node.lo;
+    for (int i = first; i < last; i++) {
+      const StlTriangle& t = bvh->tris[order[i]];
+      for (int d = 0; d < 3; d++) {
+        for (int iv = 0; iv < 3; iv++) {
+          node.lo[d] = std::min(node.lo[d], t.v[iv][d]);
+          node.hi[d] = std::max(node.hi[d], t.v[iv][d]);
+        }
+        clo[d] = std::min(clo[d], cent[order[i]][d]);
+        chi[d] = std::max(chi[d], cent[order[i]][d]);
+      }
+    }
+
+    int axis = 0;
+    for (int d = 1; d < 3; d++) {
+      if (chi[d] - clo[d] > chi[axis] - clo[axis]) {
+        axis = d;
+      }
+    }
+    if (node.count <= leaf_size || chi[axis] == clo[axis]) {
+      nodes[in] = node;
+      continue;
+    }
+
+    const int mid = first + node.count / 2;
+    std::nth_element(
+      order.begin() + first, order.begin() + mid, order.begin() + last,
+      [&](const int i, const int j) { return cent[i][axis] < cent[j][axis]; });
+    node.left = nodes.size();
+    node.count = 0;
+    nodes[in] = node;
+    StlIF::Node l;
+    l.first = first;
+    l.count = mid - first;
+    StlIF::Node r;
+    r.first = mid;
+    r.count = last - mid;
+    nodes.push_back(l);
+    nodes.push_back(r);
+    stack.push_back(node.left);
+    stack.push_back(node.left + 1);
+  }
+
+  std::vector<StlTriangle> sorted(ntri);
+  for (int i = 0; i < ntri; i++) {
+    sorted[i] = bvh->tris[order[i]];
+  }
+  bvh->tris.swap(sorted);
+  return bvh;
+}
+
+std::vector<StlTriangle>
+read_stl_file(
+  const std::string& fname, const amrex::Real scale, const StlPoint& center)
+{
+  amrex::Vector<char> buf;
+  amrex::ParallelDescriptor::ReadAndBcastFile(fname, buf);
+  // The buffer is null terminated
+  std::vector<StlTriangle> tris = read_stl(buf.dataPtr(), buf.size() - 1);
+  if (tris.empty()) {
+    amrex::Abort("StlIF: no triangles read from " + fname);
+  }
+  for (auto& t : tris) {
+    for (int iv = 0; iv < 3; iv++) {
+      for (int d = 0; d < 3; d++) {
+        t.v[iv][d] = scale * t.v[iv][d] + center[d];
+      }
+    }
+  }
+  return tris;
+}
+
+} // namespace
+
+std::vector<StlTriangle>
+read_stl(const char* buf, const std::size_t nbytes)
+{
+  std::vector<StlTriangle> tris;
+
+  // Binary: 80 byte header, number of triangles, then 50 bytes for each:
+  // normal and vertices as 32 bit floats, attribute
+  if (nbytes >= 84) {
+    std::uint32_t n = 0;
+    std::memcpy(&n, buf + 80, sizeof(n));
+    if (nbytes == 84 + 50 * static_cast<std::size_t>(n)) {
+      tris.resize(n);
+      for (std::size_t i = 0; i < n; i++) {
+        float f[12];
+        std::memcpy(f, buf + 84 + 50 * i, sizeof(f));
+        for (int iv = 0; iv < 3; iv++) {
+          for (int d = 0; d < 3; d++) {
+            tris[i].v[iv][d] = f[3 + 3 * iv + d];
+          }
+        }
+      }
+      return tris;
+    }
+  }
+
+  // ASCII: the three vertex lines of each facet
+  std::istringstream is(std::string(buf, nbytes));
+  std::string word;
+  StlTriangle t;
+  int iv = 0;
+  while (is >> word) {
+    if (word == "vertex") {
+      is >> t.v[iv][0] >> t.v[iv][1] >> t.v[iv][2];
+      if (++iv == 3) {
+        tris.push_back(t);
+        iv = 0;
+      }
+    }
+  }
+  return tris;
+}
+
+amrex::Real
+stl_triangle_dist2(const StlPoint& p, const StlTriangle& t)
+{
+  // Closest point by the Voronoi regions of the vertices, edges and face
+  const StlPoint& a = t.v[0];
+  const StlPoint& b = t.v[1];
+  const StlPoint& c = t.v[2];
+  const StlPoint ab = sub(b, a);
+  const StlPoint ac = sub(c, a);
+  const StlPoint ap = sub(p, a);
+  const amrex::Real d1 = dot(ab, ap);
+  const amrex::Real d2 = dot(ac, ap);
+  if (d1 <= 0.0 && d2 <= 0.0) {
+    return dot(ap, ap);
+  }
+  const StlPoint bp = sub(p, b);
+  const amrex::Real d3 = dot(ab, bp);
+  const amrex::Real d4 = dot(ac, bp);
+  if (d3 >= 0.0 && d4 <= d3) {
+    return dot(bp, bp);
+  }
+  const amrex::Real vc = d1 * d4 - d3 * d2;
+  if (vc <= 0.0 && d1 >= 0.0 && d3 <= 0.0) {
+    return dist2(p, a, ab, d1 / (d1 - d3), ac, 0.0);
+  }
+  const StlPoint cp = sub(p, c);
+  const amrex::Real d5 = dot(ab, cp);
+  const amrex::Real d6 = dot(ac, cp);
+  if (d6 >= 0.0 && d5 <= d6) {
+    return dot(cp, cp);
+  }
+  const amrex::Real vb = d5 * d2 - d1 * d6;
+  if (vb <= 0.0 && d2 >= 0.0 && d6 <= 0.0) {
+    return dist2(p, a, ab, 0.0, ac, d2 / (d2 - d6));
+  }
+  const amrex::Real va = d3 * d6 - d5 * d4;
+  if (va <= 0.0 && (d4 - d3) >= 0.0 && (d5 - d6) >= 0.0) {
+    const amrex::Real w = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+    return dist2(p, b, sub(c, b), w, ac, 0.0);
+  }
+  const amrex::Real denom = 1.0 / (va + vb + vc);
+  return dist2(p, a, ab, vb * denom, ac, vc * denom);
+}
+
+StlIF::StlIF(
+  const std::string& fname,
+  const amrex::Real scale,
+  const StlPoint& center,
+  const bool fluid_inside)
+  : StlIF(read_stl_file(fname, scale, center), fluid_inside)
+{
+}
+
+StlIF::StlIF(std::vector<StlTriangle> tris, const bool fluid_inside)
+  : m_bvh(make_bvh(std::move(tris))), m_fluid_inside(fluid_inside)
+{
+}
+
+amrex::Real
+StlIF::operator()(const amrex::RealArray& p) const
+{
+  const StlPoint q = {AMREX_D_DECL(p[0], p[1], p[2])};
+  const amrex::Real d = distance(q);
+  return (inside(q) != m_fluid_inside) ? d : -d;
+}
+
+amrex::Real
+StlIF::distance(const StlPoint& p) const
+{
+  const auto& nodes = m_bvh->nodes;
+  const auto& tris = m_bvh->tris;
+
+  // Nodes to visit with the squared distance to their box, the nearer
+  // child on top
+  std::pair<amrex::Real, int> stack[max_depth + 1];
+  int n = 0;
+  stack[n++] = {box_dist2(p, nodes[0]), 0};
+  amrex::Real best = std::numeric_limits<amrex::Real>::max();
+  while (n > 0) {
+    const auto top = stack[--n];
+    if (top.first >= best) {
+      continue;
+    }
+    const Node& node = nodes[top.second];
+    if (node.count > 0) {
+      for (int i = node.first; i < node.first + node.count; i++) {
+        best = std::min(best, stl_triangle_dist2(p, tris[i]));
+      }
+      continue;
+    }
+    const int l = node.left;
+    const amrex::Real dl = box_dist2(p, nodes[l]);
+    const amrex::Real dr = box_dist2(p, nodes[l + 1]);
+    const std::pair<amrex::Real, int> near =
+      (dl <= dr) ? std::make_pair(dl, l) : std::make_pair(dr, l + 1);
+    const std::pair<amrex::Real, int> far =
+      (dl <= dr) ? std::make_pair(dr, l + 1) : std::make_pair(dl, l);
+    if (far.first < best) {
+      stack[n++] = far;
+    }
+    if (near.first < best) {
+      stack[n++] = near;
+    }
+  }
+  return std::sqrt(best);
+}
+
+bool
+StlIF::inside(const StlPoint& p) const
+{
+  const auto& nodes = m_bvh->nodes;
+  const auto& tris = m_bvh->tris;
+
+  int crossings = 0;
+  int stack[max_depth + 1];
+  int n = 0;
+  stack[n++] = 0;
+  while (n > 0) {
+    const Node& node = nodes[stack[--n]];
+    if (
+      p[0] > node.hi[0] || p[1] < node.lo[1] || p[1] > node.hi[1] ||
+      p[2] < node.lo[2] || p[2] > node.hi[2]) {
+      continue;
+    }
+    if (node.count > 0) {
+      for (int i = node.first; i < node.first + node.count; i++) {
+        crossings += ray_crosses(p, tris[i]);
+      }
+      continue;
+    }
+    stack[n++] = node.left;
+    stack[n++] = node.left + 1;
+  }
+  return (crossings % 2) == 1;
+}
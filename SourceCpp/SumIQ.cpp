@@ -1,6 +1,163 @@
 #include <iomanip>
 
 #include "PeleC.H"
+#include "Derive.H"
+
+namespace {
+
+// Quantities integrated by sum_integrated_quantities, in the order of the
+// data log columns. The names are the ones accepted by pelec.sum_iq_vars.
+enum IntegratedQuantity {
+  iq_mass = 0,
+  iq_xmom,
+  iq_ymom,
+  iq_zmom,
+  iq_rho_K,
+  iq_rho_e,
+  iq_rho_E,
+  iq_enstr,
+  iq_fuel_prod,
+  iq_temp,
+  num_iq
+};
+
+const char* iq_names[num_iq] = {"mass",  "xmom",  "ymom",  "zmom",
+                                "rho_K", "rho_e", "rho_E", "enstr",
+                                "fuel_prod", "temp"};
+
+const char* iq_labels[num_iq] = {
+  "MASS        ", "XMOM        ", "YMOM        ", "ZMOM        ",
+  "RHO*K       ", "RHO*e       ", "RHO*E       ", "ENSTROPHY   ",
+  "FUEL PROD   ", "TEMP        "};
+
+} // namespace
+
+void
+PeleC::volWgtSumIQ(
+  const amrex::Vector<int>& active,
+  amrex::Real time,
+  amrex::Vector<amrex::Real>& sums,
+  amrex::Real& fill_time)
+{
+  BL_PROFILE("PeleC::volWgtSumIQ()");
+
+  AMREX_ASSERT(active.size() == num_iq);
+  amrex::GpuArray<int, num_iq> act;
+  for (int n = 0; n < num_iq; n++) {
+    act[n] = active[n];
+  }
+
+  // Only the enstrophy needs ghost cells
+  const amrex::Real t0 = amrex::ParallelDescriptor::second();
+  const int ng = act[iq_enstr] ? 1 : 0;
+  amrex::MultiFab Sborder;
+  if (ng > 0) {
+    Sborder.define(grids, dmap, NVAR, ng, amrex::MFInfo(), Factory());
+    FillPatch(*this, Sborder, ng, time, State_Type, 0, NVAR);
+  }
+  const amrex::MultiFab& S = (ng > 0) ? Sborder : get_data(State_Type, time);
+  fill_time += amrex::ParallelDescriptor::second() - t0;
+
+  const amrex::MultiFab* R = nullptr;
+  int fuel_comp = -1;
+#ifdef PELEC_USE_REACTIONS
+  if (act[iq_fuel_prod] && fuel_name != "") {
+    for (int n = 0; n < NUM_SPECIES; n++) {
+      if (spec_names[n] == fuel_name) {
+        fuel_comp = n;
+      }
+    }
+    if (fuel_comp < 0) {
+      amrex::Abort("PeleC::volWgtSumIQ: unknown fuel_name " + fuel_name);
+    }
+    R = &get_data(Reactions_Type, time);
+  }
+#endif
+
+  const bool use_mask = level < parent->finestLevel();
+  const amrex::MultiFab* mask =
+    use_mask ? &getLevel(level + 1).build_fine_mask() : nullptr;
+
+  AMREX_D_TERM(const amrex::Real dx = geom.CellSize(0);
+               , const amrex::Real dy = geom.CellSize(1);
+               , const amrex::Real dz = geom.CellSize(2););
+
+  amrex::ReduceOps<
+    amrex::ReduceOpSum, amrex::ReduceOpSum, amrex::ReduceOpSum,
+    amrex::ReduceOpSum, amrex::ReduceOpSum, amrex::ReduceOpSum,
+    amrex::ReduceOpSum, amrex::ReduceOpSum, amrex::ReduceOpSum,
+    amrex::ReduceOpSum>
+    reduce_op;
+  amrex::ReduceData<
+    amrex::Real, amrex::Real, amrex::Real, amrex::Real, amrex::Real,
+    amrex::Real, amrex::Real, amrex::Real, amrex::Real, amrex::Real>
+    reduce_data(reduce_op);
+  using ReduceTuple = typename decltype(reduce_data)::Type;
+
+#ifdef _OPENMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
+  for (amrex::MFIter mfi(S, amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+    const amrex::Box& bx = mfi.tilebox();
+    auto const& sarr = S.const_array(mfi);
+    auto const& vol = volume.const_array(mfi);
+    auto const& rarr =
+      (R != nullptr) ? R->const_array(mfi) : amrex::Array4<const amrex::Real>{};
+    auto const& marr = use_mask ? mask->const_array(mfi)
+                                : amrex::Array4<const amrex::Real>{};
+#ifdef PELEC_USE_EB
+    auto const& vfarr = vfrac.const_array(mfi);
+#endif
+    reduce_op.eval(
+      bx, reduce_data,
+      [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept -> ReduceTuple {
+        amrex::Real w = vol(i, j, k);
+        if (use_mask) {
+          w *= marr(i, j, k);
+        }
+#ifdef PELEC_USE_EB
+        w *= vfarr(i, j, k);
+#endif
+        const amrex::Real rho = sarr(i, j, k, URHO);
+        const amrex::Real mx = sarr(i, j, k, UMX);
+        const amrex::Real my = sarr(i, j, k, UMY);
+        const amrex::Real mz = sarr(i, j, k, UMZ);
+
+        amrex::Real enstr = 0.0;
+        if (act[iq_enstr]) {
+          enstr = pc_enstrophy(i, j, k, sarr, AMREX_D_DECL(dx, dy, dz));
+        }
+        amrex::Real fuel_prod = 0.0;
+        if (fuel_comp >= 0) {
+          fuel_prod = rarr(i, j, k, fuel_comp);
+        }
+
+        return {act[iq_mass] ? w * rho : 0.0,
+                act[iq_xmom] ? w * mx : 0.0,
+                act[iq_ymom] ? w * my : 0.0,
+                act[iq_zmom] ? w * mz : 0.0,
+                act[iq_rho_K] ? w * 0.5 * (mx * mx + my * my + mz * mz) / rho
+                              : 0.0,
+                act[iq_rho_e] ? w * sarr(i, j, k, UEINT) : 0.0,
+                act[iq_rho_E] ? w * sarr(i, j, k, UEDEN) : 0.0,
+                w * enstr,
+                w * fuel_prod,
+                act[iq_temp] ? w * sarr(i, j, k, UTEMP) : 0.0};
+      });
+  }
+
+  ReduceTuple hv = reduce_data.value();
+  sums[iq_mass] += amrex::get<iq_mass>(hv);
+  sums[iq_xmom] += amrex::get<iq_xmom>(hv);
+  sums[iq_ymom] += amrex::get<iq_ymom>(hv);
+  sums[iq_zmom] += amrex::get<iq_zmom>(hv);
+  sums[iq_rho_K] += amrex::get<iq_rho_K>(hv);
+  sums[iq_rho_e] += amrex::get<iq_rho_e>(hv);
+  sums[iq_rho_E] += amrex::get<iq_rho_E>(hv);
+  sums[iq_enstr] += amrex::get<iq_enstr>(hv);
+  sums[iq_fuel_prod] += amrex::get<iq_fuel_prod>(hv);
+  sums[iq_temp] += amrex::get<iq_temp>(hv);
+}
 
 void
 PeleC::sum_integrated_quantities()
@@ -10,123 +167,82 @@ PeleC::sum_integrated_quantities()
   if (verbose <= 0)
     return;
 
-  bool local_flag = true;
+  // All the quantities are reported unless pelec.sum_iq_vars is given
+  amrex::Vector<int> active(num_iq, sum_iq_vars.empty() ? 1 : 0);
+  for (const auto& name : sum_iq_vars) {
+    bool found = false;
+    for (int n = 0; n < num_iq; n++) {
+      if (name == iq_names[n]) {
+        active[n] = 1;
+        found = true;
+      }
+    }
+    if (!found) {
+      amrex::Abort("Unknown integrated quantity in pelec.sum_iq_vars: " + name);
+    }
+  }
 
+  const amrex::Real t_start = amrex::ParallelDescriptor::second();
   int finest_level = parent->finestLevel();
   amrex::Real time = state[State_Type].curTime();
-  amrex::Real mass = 0.0;
-  amrex::Real mom[3] = {0.0};
-  amrex::Real rho_e = 0.0;
-  amrex::Real rho_K = 0.0;
-  amrex::Real rho_E = 0.0;
-  amrex::Real enstr = 0.0;
-  amrex::Real fuel_prod = 0;
-  amrex::Real temp = 0;
+  amrex::Vector<amrex::Real> sums(num_iq, 0.0);
+  amrex::Real fill_time = 0.0;
   int datwidth = 14;
   int datprecision = 6;
 
   for (int lev = 0; lev <= finest_level; lev++) {
-    PeleC& pc_lev = getLevel(lev);
-
-    mass += pc_lev.volWgtSum("density", time, local_flag);
-    mom[0] += pc_lev.volWgtSum("xmom", time, local_flag);
-    mom[1] += pc_lev.volWgtSum("ymom", time, local_flag);
-    mom[2] += pc_lev.volWgtSum("zmom", time, local_flag);
-    rho_e += pc_lev.volWgtSum("rho_e", time, local_flag);
-    rho_K += pc_lev.volWgtSum("kineng", time, local_flag);
-    rho_E += pc_lev.volWgtSum("rho_E", time, local_flag);
-    enstr += pc_lev.volWgtSum("enstrophy", time, local_flag);
-
-    if (fuel_name != "") {
-      fuel_prod += pc_lev.volWgtSum("rho_omega_" + fuel_name, time, local_flag);
-    }
-
-    temp += pc_lev.volWgtSum("Temp", time, local_flag);
+    getLevel(lev).volWgtSumIQ(active, time, sums, fill_time);
   }
+  const amrex::Real sum_time =
+    amrex::ParallelDescriptor::second() - t_start - fill_time;
 
   if (verbose > 0) {
-    const int nfoo = 10;
-    amrex::Real foo[nfoo] = {mass,  mom[0], mom[1], mom[2],    rho_e,
-                             rho_K, rho_E,  enstr,  fuel_prod, temp};
+    const int print_timing = verbose > 1;
 #ifdef AMREX_LAZY
     Lazy::QueueReduction([=]() mutable {
 #endif
+      const amrex::Real t_comm = amrex::ParallelDescriptor::second();
       amrex::ParallelDescriptor::ReduceRealSum(
-        foo, nfoo, amrex::ParallelDescriptor::IOProcessorNumber());
+        sums.data(), num_iq, amrex::ParallelDescriptor::IOProcessorNumber());
+      const amrex::Real comm_time =
+        amrex::ParallelDescriptor::second() - t_comm;
 
       if (amrex::ParallelDescriptor::IOProcessor()) {
-        int i = 0;
-        mass = foo[i++];
-        mom[0] = foo[i++];
-        mom[1] = foo[i++];
-        mom[2] = foo[i++];
-        rho_e = foo[i++];
-        rho_K = foo[i++];
-        rho_E = foo[i++];
-        enstr = foo[i++];
-        fuel_prod = foo[i++];
-        temp = foo[i++];
-
         amrex::Print() << '\n';
-        amrex::Print() << "TIME= " << time << " MASS        = " << mass << '\n';
-        amrex::Print() << "TIME= " << time << " XMOM        = " << mom[0]
-                       << '\n';
-        amrex::Print() << "TIME= " << time << " YMOM        = " << mom[1]
-                       << '\n';
-        amrex::Print() << "TIME= " << time << " ZMOM        = " << mom[2]
-                       << '\n';
-        amrex::Print() << "TIME= " << time << " RHO*e       = " << rho_e
-                       << '\n';
-        amrex::Print() << "TIME= " << time << " RHO*K       = " << rho_K
-                       << '\n';
-        amrex::Print() << "TIME= " << time << " RHO*E       = " << rho_E
-                       << '\n';
-        amrex::Print() << "TIME= " << time << " ENSTROPHY   = " << enstr
-                       << '\n';
-        amrex::Print() << "TIME= " << time << " FUEL PROD   = " << fuel_prod
-                       << '\n';
-        amrex::Print() << "TIME= " << time << " TEMP        = " << temp << '\n';
+        for (int n = 0; n < num_iq; n++) {
+          if (active[n]) {
+            amrex::Print() << "TIME= " << time << " " << iq_labels[n] << "= "
+                           << sums[n] << '\n';
+          }
+        }
+        if (print_timing) {
+          amrex::Print() << "TIME= " << time
+                         << " sum_integrated_quantities: fill " << fill_time
+                         << " s, reduce " << sum_time << " s, comm "
+                         << comm_time << " s" << '\n';
+        }
 
         if (parent->NumDataLogs() > 0) {
           std::ostream& data_log1 = parent->DataLog(0);
           if (data_log1.good()) {
             if (time == 0.0) {
-              data_log1 << std::setw(datwidth) << "          time";
-              data_log1 << std::setw(datwidth) << "          mass";
-              data_log1 << std::setw(datwidth) << "          xmom";
-              data_log1 << std::setw(datwidth) << "          ymom";
-              data_log1 << std::setw(datwidth) << "          zmom";
-              data_log1 << std::setw(datwidth) << "         rho_K";
-              data_log1 << std::setw(datwidth) << "         rho_e";
-              data_log1 << std::setw(datwidth) << "         rho_E";
-              data_log1 << std::setw(datwidth) << "         enstr";
-              data_log1 << std::setw(datwidth) << "     fuel_prod";
-              data_log1 << std::setw(datwidth) << "          temp";
+              data_log1 << std::setw(datwidth) << "time";
+              for (int n = 0; n < num_iq; n++) {
+                if (active[n]) {
+                  data_log1 << std::setw(datwidth) << iq_names[n];
+                }
+              }
               data_log1 << std::endl;
             }
 
             // Write the quantities at this time
             data_log1 << std::setw(datwidth) << time;
-            data_log1 << std::setw(datwidth) << std::setprecision(datprecision)
-                      << mass;
-            data_log1 << std::setw(datwidth) << std::setprecision(datprecision)
-                      << mom[0];
-            data_log1 << std::setw(datwidth) << std::setprecision(datprecision)
-                      << mom[1];
-            data_log1 << std::setw(datwidth) << std::setprecision(datprecision)
-                      << mom[2];
-            data_log1 << std::setw(datwidth) << std::setprecision(datprecision)
-                      << rho_K;
-            data_log1 << std::setw(datwidth) << std::setprecision(datprecision)
-                      << rho_e;
-            data_log1 << std::setw(datwidth) << std::setprecision(datprecision)
-                      << rho_E;
-            data_log1 << std::setw(datwidth) << std::setprecision(datprecision)
-                      << enstr;
-            data_log1 << std::setw(datwidth) << std::setprecision(datprecision)
-                      << fuel_prod;
-            data_log1 << std::setw(datwidth) << std::setprecision(datprecision)
-                      << temp;
+            for (int n = 0; n < num_iq; n++) {
+              if (active[n]) {
+                data_log1 << std::setw(datwidth)
+                          << std::setprecision(datprecision) << sums[n];
+              }
+            }
             data_log1 << std::endl;
           }
         }
@@ -34,6 +34,8 @@ AMREX_GPU_DEVICE_MANAGED int max_ftracgrad_lev = 10;
 
 AMREX_GPU_DEVICE_MANAGED amrex::Real vfracerr = 1.0e10;
 AMREX_GPU_DEVICE_MANAGED int max_vfracerr_lev = 10;
+
+int set_criteria = 0;
 } // namespace TaggingParm
 
 void
@@ -41,34 +43,57 @@ PeleC::read_tagging_params()
 {
   amrex::ParmParse pp("tagging");
 
-  pp.query("denerr", TaggingParm::denerr);
+  if (pp.query("denerr", TaggingParm::denerr)) {
+    TaggingParm::set_criteria |= 1 << tag_denerr;
+  }
   pp.query("max_denerr_lev", TaggingParm::max_denerr_lev);
-  pp.query("dengrad", TaggingParm::dengrad);
+  if (pp.query("dengrad", TaggingParm::dengrad)) {
+    TaggingParm::set_criteria |= 1 << tag_dengrad;
+  }
   pp.query("max_dengrad_lev", TaggingParm::max_dengrad_lev);
 
-  pp.query("presserr", TaggingParm::presserr);
+  if (pp.query("presserr", TaggingParm::presserr)) {
+    TaggingParm::set_criteria |= 1 << tag_presserr;
+  }
   pp.query("max_presserr_lev", TaggingParm::max_presserr_lev);
-  pp.query("pressgrad", TaggingParm::pressgrad);
+  if (pp.query("pressgrad", TaggingParm::pressgrad)) {
+    TaggingParm::set_criteria |= 1 << tag_pressgrad;
+  }
   pp.query("max_pressgrad_lev", TaggingParm::max_pressgrad_lev);
 
-  pp.query("velerr", TaggingParm::velerr);
+  if (pp.query("velerr", TaggingParm::velerr)) {
+    TaggingParm::set_criteria |= 1 << tag_velerr;
+  }
   pp.query("max_velerr_lev", TaggingParm::max_velerr_lev);
-  pp.query("velgrad", TaggingParm::velgrad);
+  if (pp.query("velgrad", TaggingParm::velgrad)) {
+    TaggingParm::set_criteria |= 1 << tag_velgrad;
+  }
   pp.query("max_velgrad_lev", TaggingParm::max_velgrad_lev);
 
-  pp.query("vorterr", TaggingParm::vorterr);
+  if (pp.query("vorterr", TaggingParm::vorterr)) {
+    TaggingParm::set_criteria |= 1 << tag_vorterr;
+  }
   pp.query("max_vorterr_lev", TaggingParm::max_vorterr_lev);
 
-  pp.query("temperr", TaggingParm::temperr);
+  if (pp.query("temperr", TaggingParm::temperr)) {
+    TaggingParm::set_criteria |= 1 << tag_temperr;
+  }
   pp.query("max_temperr_lev", TaggingParm::max_temperr_lev);
-  pp.query("tempgrad", TaggingParm::tempgrad);
+  if (pp.query("tempgrad", TaggingParm::tempgrad)) {
+    TaggingParm::set_criteria |= 1 << tag_tempgrad;
+  }
   pp.query("max_tempgrad_lev", TaggingParm::max_tempgrad_lev);
 
-  pp.query("ftracerr", TaggingParm::ftracerr);
+  if (pp.query("ftracerr", TaggingParm::ftracerr)) {
+    TaggingParm::set_criteria |= 1 << tag_ftracerr;
+  }
   pp.query("max_ftracerr_lev", TaggingParm::max_ftracerr_lev);
-  pp.query("ftracgrad", TaggingParm::ftracgrad);
+  if (pp.query("ftracgrad", TaggingParm::ftracgrad)) {
+    TaggingParm::set_criteria |= 1 << tag_ftracgrad;
+  }
   pp.query("max_ftracgrad_lev", TaggingParm::max_ftracgrad_lev);
 
   pp.query("vfracerr", TaggingParm::vfracerr);
+  TaggingParm::set_criteria |= 1 << tag_vfracerr;
   pp.query("max_vfracerr_lev", TaggingParm::max_vfracerr_lev);
 }
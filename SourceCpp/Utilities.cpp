@@ -1,3 +1,15 @@
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define PELEC_USE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #include "Utilities.H"
 
 AMREX_GPU_DEVICE
@@ -156,14 +168,131 @@ pc_rst_int_e(
   }
 }
 
+MappedFile::MappedFile(const std::string& iname)
+{
+#ifdef PELEC_USE_MMAP
+  const int fd = open(iname.c_str(), O_RDONLY);
+  if (fd < 0) {
+    amrex::Abort("Unable to open input file " + iname);
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    close(fd);
+    amrex::Abort("Unable to stat input file " + iname);
+  }
+  m_size = static_cast<size_t>(st.st_size);
+  if (m_size > 0) {
+    void* addr = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (addr != MAP_FAILED) {
+      // The file is read front to back exactly once
+      madvise(addr, m_size, MADV_SEQUENTIAL);
+      m_data = static_cast<const char*>(addr);
+      m_mapped = true;
+    }
+  }
+  close(fd);
+  if (m_mapped || m_size == 0) {
+    return;
+  }
+#endif
+
+  // Fall back on a single bulk read of the whole file
+  std::ifstream infile(iname, std::ios::in | std::ios::binary);
+  if (not infile.is_open()) {
+    amrex::Abort("Unable to open input file " + iname);
+  }
+  infile.seekg(0, std::ios::end);
+  m_size = static_cast<size_t>(infile.tellg());
+  infile.seekg(0, std::ios::beg);
+  m_buffer.resize(m_size);
+  infile.read(&m_buffer[0], m_size);
+  if (static_cast<size_t>(infile.gcount()) != m_size) {
+    amrex::Abort("Unable to read input file " + iname);
+  }
+  m_data = m_buffer.data();
+}
+
+MappedFile::~MappedFile()
+{
+#ifdef PELEC_USE_MMAP
+  if (m_mapped) {
+    munmap(const_cast<char*>(m_data), m_size);
+  }
+#endif
+}
+
+namespace {
+
+// Run the read on the first rank of each node and broadcast the data to the
+// other ranks sharing the node
+template <typename F>
+void
+node_read_bcast(
+  amrex::Vector<amrex::Real>& data, const bool node_bcast, F&& read)
+{
+#ifdef BL_USE_MPI
+  if (node_bcast && amrex::ParallelDescriptor::NProcs() > 1) {
+    MPI_Comm node_comm;
+    MPI_Comm_split_type(
+      amrex::ParallelDescriptor::Communicator(), MPI_COMM_TYPE_SHARED,
+      amrex::ParallelDescriptor::MyProc(), MPI_INFO_NULL, &node_comm);
+    int node_rank = 0;
+    MPI_Comm_rank(node_comm, &node_rank);
+    if (node_rank == 0) {
+      read();
+    }
+
+    // Chunked to stay within the int counts of MPI
+    MPI_Datatype mpi_real =
+      amrex::ParallelDescriptor::Mpi_typemap<amrex::Real>::type();
+    const size_t chunk = std::numeric_limits<int>::max();
+    for (size_t off = 0; off < data.size(); off += chunk) {
+      const int cnt = static_cast<int>(std::min(chunk, data.size() - off));
+      MPI_Bcast(data.data() + off, cnt, mpi_real, 0, node_comm);
+    }
+    MPI_Comm_free(&node_comm);
+    return;
+  }
+#else
+  amrex::ignore_unused(data, node_bcast);
+#endif
+  read();
+}
+
+} // namespace
+
+BinaryView::BinaryView(
+  const std::string& iname,
+  const size_t nx,
+  const size_t ny,
+  const size_t nz,
+  const size_t ncol)
+  : m_file(iname), m_nval(nx * ny * nz * ncol)
+{
+  if (m_file.size() < m_nval * sizeof(double)) {
+    amrex::Abort(
+      "Size of the input file " + iname + " (= " +
+      std::to_string(m_file.size()) + " bytes) does not match the input " +
+      "resolution (= " + std::to_string(m_nval) + " doubles)");
+  }
+
+  // Mappings are page aligned and the fallback buffer is allocated with new,
+  // so the doubles can be read in place
+  AMREX_ALWAYS_ASSERT(
+    reinterpret_cast<std::uintptr_t>(m_file.data()) % alignof(double) == 0);
+  m_data = reinterpret_cast<const double*>(m_file.data());
+}
+
 // -----------------------------------------------------------
 // Read a binary file
 // INPUTS/OUTPUTS:
-// iname => filename
-// nx    => input resolution
-// ny    => input resolution
-// nz    => input resolution
-// data  <= output data
+// iname      => filename
+// nx         => input resolution
+// ny         => input resolution
+// nz         => input resolution
+// ncol       => number of columns
+// data       <= output data
+// node_bcast => read on one rank per node and broadcast
 // -----------------------------------------------------------
 void
 read_binary(
@@ -172,28 +301,37 @@ read_binary(
   const size_t ny,
   const size_t nz,
   const size_t ncol,
-  amrex::Vector<double>& data /*needs to be double*/)
+  amrex::Vector<amrex::Real>& data,
+  const bool node_bcast)
 {
-
-  std::ifstream infile(iname, std::ios::in | std::ios::binary);
-  if (not infile.is_open()) {
-    amrex::Abort("Unable to open input file " + iname);
+  const size_t nval = nx * ny * nz * ncol;
+  if (data.size() < nval) {
+    amrex::Abort("read_binary: output array too small for " + iname);
   }
 
-  for (int i = 0; i < nx * ny * nz * ncol; i++) {
-    infile.read(reinterpret_cast<char*>(&data[i]), sizeof(data[i]));
-  }
-  infile.close();
+  node_read_bcast(data, node_bcast, [&]() {
+    // The file holds doubles, converted on the way if the build is in single
+    // precision
+    const BinaryView view(iname, nx, ny, nz, ncol);
+    if (std::is_same<amrex::Real, double>::value) {
+      std::memcpy(data.data(), view.data(), nval * sizeof(double));
+    } else {
+      for (size_t i = 0; i < nval; i++) {
+        data[i] = static_cast<amrex::Real>(view[i]);
+      }
+    }
+  });
 };
 
 // -----------------------------------------------------------
 // Read a csv file
 // INPUTS/OUTPUTS:
-// iname => filename
-// nx    => input resolution
-// ny    => input resolution
-// nz    => input resolution
-// data  <= output data
+// iname      => filename
+// nx         => input resolution
+// ny         => input resolution
+// nz         => input resolution
+// data       <= output data
+// node_bcast => read on one rank per node and broadcast
 // -----------------------------------------------------------
 void
 read_csv(
@@ -201,43 +339,62 @@ read_csv(
   const size_t nx,
   const size_t ny,
   const size_t nz,
-  amrex::Vector<amrex::Real>& data)
+  amrex::Vector<amrex::Real>& data,
+  const bool node_bcast)
 {
-  std::ifstream infile(iname, std::ios::in);
-  const std::string memfile = read_file(infile);
-  if (not infile.is_open()) {
-    amrex::Abort("Unable to open input file " + iname);
-  }
-  infile.close();
-  std::istringstream iss(memfile);
+  node_read_bcast(data, node_bcast, [&]() {
+    const MappedFile infile(iname);
+    const char* p = infile.data();
+    const char* const end = p + infile.size();
 
-  // Read the file
-  int nlines = 0;
-  std::string firstline, line;
-  std::getline(iss, firstline); // skip header
-  while (getline(iss, line))
-    ++nlines;
+    // Skip the header
+    p = static_cast<const char*>(std::memchr(p, '\n', end - p));
+    p = (p == nullptr) ? end : p + 1;
 
-  // Quick sanity check
-  if (nlines != nx * ny * nz)
-    amrex::Abort(
-      "Number of lines in the input file (= " + std::to_string(nlines) +
-      ") does not match the input resolution (=" + std::to_string(nx) + ")");
-
-  // Read the data from the file
-  iss.clear();
-  iss.seekg(0, std::ios::beg);
-  std::getline(iss, firstline); // skip header
-  int cnt = 0;
-  while (std::getline(iss, line)) {
-    std::istringstream linestream(line);
-    std::string value;
-    while (getline(linestream, value, ',')) {
-      std::istringstream sinput(value);
-      sinput >> data[cnt];
-      cnt++;
+    // Single pass over the fields. The file is not null terminated, so each
+    // field is copied to a small buffer before handing it to strtod.
+    size_t nlines = 0;
+    size_t cnt = 0;
+    char buf[64];
+    while (p < end) {
+      const char* eol = static_cast<const char*>(std::memchr(p, '\n', end - p));
+      if (eol == nullptr) {
+        eol = end;
+      }
+      const char* e = eol;
+      while (e > p && (*(e - 1) == '\r' || *(e - 1) == ' ')) {
+        --e;
+      }
+      if (e > p) {
+        ++nlines;
+        while (p < e) {
+          const char* f = static_cast<const char*>(std::memchr(p, ',', e - p));
+          if (f == nullptr) {
+            f = e;
+          }
+          const size_t len = static_cast<size_t>(f - p);
+          if (len >= sizeof(buf)) {
+            amrex::Abort("read_csv: field too long in " + iname);
+          }
+          if (cnt >= data.size()) {
+            amrex::Abort("read_csv: too many values in " + iname);
+          }
+          std::memcpy(buf, p, len);
+          buf[len] = '\0';
+          data[cnt++] = std::strtod(buf, nullptr);
+          p = (f < e) ? f + 1 : e;
+        }
+      }
+      p = (eol < end) ? eol + 1 : end;
     }
-  }
+
+    // Quick sanity check
+    if (nlines != nx * ny * nz)
+      amrex::Abort(
+        "Number of lines in the input file (= " + std::to_string(nlines) +
+        ") does not match the input resolution (=" + std::to_string(nx) +
+        ")");
+  });
 };
 
 // -----------------------------------------------------------
@@ -0,0 +1,22 @@
+#include <AMReX.H>
+#include <AMReX_Print.H>
+
+#include "PltCompress.H"
+
+int
+main(int argc, char* argv[])
+{
+  amrex::Initialize(argc, argv, false);
+  {
+    if (argc < 2) {
+      amrex::Print() << "Usage: " << argv[0] << " plotfile [plotfile ...]"
+                     << std::endl;
+      amrex::Abort("No plotfile given");
+    }
+    for (int i = 1; i < argc; i++) {
+      pltcompress::decompress_plotfile(argv[i]);
+    }
+  }
+  amrex::Finalize();
+  return 0;
+}